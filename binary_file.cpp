@@ -0,0 +1,185 @@
+#include "binary_file.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+void storeLittle(uint8_t *out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t loadLittle(const uint8_t *in, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+MappedFile::MappedFile() : bytes(nullptr), length(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        message = "cannot open " + path;
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    bytes = contents.empty() ? nullptr : contents.data();
+    length = contents.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        message = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        message = "cannot open " + path;
+        return false;
+    }
+    if (info.st_size > 0)
+    {
+        length = static_cast<size_t>(info.st_size);
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            length = 0;
+            message = "cannot map " + path;
+            return false;
+        }
+        bytes = static_cast<const uint8_t *>(mapping);
+    }
+    ::close(fd); // the mapping keeps the file alive
+#endif
+
+    message.clear();
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    contents.clear();
+#else
+    if (bytes)
+    {
+        munmap(const_cast<uint8_t *>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+}
+
+BufferedFileWriter::BufferedFileWriter(const std::string &path)
+    : out(path, std::ios::binary | std::ios::trunc), ok(out.good()), closed(false), buffer(WRITE_BUFFER_SIZE),
+      used(0)
+{
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+    close();
+}
+
+uint8_t *BufferedFileWriter::reserve(size_t count)
+{
+    if (used + count > buffer.size())
+    {
+        flush();
+    }
+    uint8_t *space = buffer.data() + used;
+    used += count;
+    return space;
+}
+
+void BufferedFileWriter::write(const uint8_t *data, size_t count)
+{
+    if (used + count > buffer.size())
+    {
+        flush();
+    }
+    if (count > buffer.size())
+    {
+        // Too big to be worth copying; goes straight out
+        if (ok)
+        {
+            out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(count));
+            ok = out.good();
+        }
+        return;
+    }
+    std::memcpy(buffer.data() + used, data, count);
+    used += count;
+}
+
+void BufferedFileWriter::patch(uint64_t offset, const uint8_t *data, size_t count)
+{
+    flush();
+    if (ok)
+    {
+        std::streampos end = out.tellp();
+        out.seekp(static_cast<std::streamoff>(offset));
+        out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(count));
+        out.seekp(end);
+        ok = out.good();
+    }
+}
+
+void BufferedFileWriter::flush()
+{
+    if (used > 0 && ok)
+    {
+        out.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(used));
+        ok = out.good();
+    }
+    used = 0;
+}
+
+bool BufferedFileWriter::close()
+{
+    if (closed)
+    {
+        return ok;
+    }
+    closed = true;
+    flush();
+    if (ok)
+    {
+        out.flush();
+        ok = out.good();
+    }
+    out.close();
+    return ok;
+}
@@ -0,0 +1,76 @@
+#ifndef BINARY_FILE_H
+#define BINARY_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Little-endian integers of `bytes` bytes (1..8), as the trace and archive
+// headers store them
+void storeLittle(uint8_t *out, uint64_t value, int bytes);
+uint64_t loadLittle(const uint8_t *in, int bytes);
+
+// A whole file, read-only. It is memory-mapped (read in once on Windows), so
+// opening costs the same whatever the size and pages load as they are read.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // False (with error() set) if the file cannot be opened or mapped
+    bool open(const std::string &path);
+    void close();
+    const std::string &error() const { return message; }
+
+    const uint8_t *data() const { return bytes; } // null for an empty file
+    size_t size() const { return length; }
+
+private:
+    const uint8_t *bytes;
+    size_t length;
+    std::string message;
+#ifdef _WIN32
+    std::vector<uint8_t> contents;
+#endif
+};
+
+// Creates a file and writes it through a 1 MB buffer. A fixed-size header can
+// go out first and be patched once the body is written.
+class BufferedFileWriter
+{
+public:
+    explicit BufferedFileWriter(const std::string &path);
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter &) = delete;
+    BufferedFileWriter &operator=(const BufferedFileWriter &) = delete;
+
+    bool good() const { return ok; }
+
+    // Room for `count` bytes (at most the buffer size) at the end of the file,
+    // to be filled in before the next call
+    uint8_t *reserve(size_t count);
+    void write(const uint8_t *data, size_t count);
+
+    // Overwrites bytes already written; the buffer is flushed first
+    void patch(uint64_t offset, const uint8_t *data, size_t count);
+
+    bool close(); // false if any write failed
+
+private:
+    void flush();
+
+    std::ofstream out;
+    bool ok;
+    bool closed;
+    std::vector<uint8_t> buffer;
+    size_t used;
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "board_constraints.h"
+#include "empty_row_search.h"
+#include "min_conflicts.h"
+#include "solver.h"
+#include "solver_stats.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+BoardConstraints randomConstraints(int n, int queens, int blocked, uint64_t seed)
+{
+    BoardConstraints constraints;
+    constraints.n = n;
+
+    MinConflictsOptions options;
+    options.seed = seed;
+    std::vector<int> solution;
+    if (n < 1 || !solveMinConflicts(n, solution, options).solved)
+    {
+        return constraints;
+    }
+
+    std::mt19937_64 random(seed);
+    std::vector<int> rows(n);
+    std::iota(rows.begin(), rows.end(), 0);
+    std::shuffle(rows.begin(), rows.end(), random);
+    queens = std::max(0, std::min(queens, n));
+    for (int i = 0; i < queens; i++)
+    {
+        constraints.queens.push_back({rows[i], solution[rows[i]]});
+    }
+    std::sort(constraints.queens.begin(), constraints.queens.end());
+
+    // Every square off the solution is a candidate; take a random subset
+    std::vector<int> squares;
+    squares.reserve(static_cast<size_t>(n) * (n - 1));
+    for (int square = 0; square < n * n; square++)
+    {
+        if (solution[square / n] != square % n)
+            squares.push_back(square);
+    }
+    blocked = std::max(0, std::min(blocked, static_cast<int>(squares.size())));
+    for (int i = 0; i < blocked; i++)
+    {
+        std::uniform_int_distribution<int> pick(i, static_cast<int>(squares.size()) - 1);
+        std::swap(squares[i], squares[pick(random)]);
+        constraints.blocked.push_back({squares[i] / n, squares[i] % n});
+    }
+    return constraints;
+}
+
+bool satisfiesConstraints(const BoardConstraints &constraints, const int *placement)
+{
+    int n = constraints.n;
+    std::vector<bool> cols(n, false);
+    std::vector<bool> diagonals(2 * n, false);
+    std::vector<bool> antiDiagonals(2 * n, false);
+    for (int row = 0; row < n; row++)
+    {
+        int col = placement[row];
+        if (col < 0 || col >= n || cols[col] || diagonals[row + col] || antiDiagonals[row - col + n - 1])
+        {
+            return false;
+        }
+        cols[col] = diagonals[row + col] = antiDiagonals[row - col + n - 1] = true;
+    }
+    for (const auto &queen : constraints.queens)
+    {
+        if (placement[queen.first] != queen.second)
+            return false;
+    }
+    for (const auto &square : constraints.blocked)
+    {
+        if (placement[square.first] == square.second)
+            return false;
+    }
+    return true;
+}
+
+bool solveInRowOrder(const BoardConstraints &constraints, int *placement, uint64_t *nodes, uint64_t nodeLimit,
+                     SolverStats *stats)
+{
+    int n = constraints.n;
+    if (n < 1 || n > MAX_BOARD_SIZE)
+    {
+        return false;
+    }
+
+    EmptyRowSearch s;
+    s.reset(n);
+    s.nodeLimit = nodeLimit;
+    s.stats = stats;
+    for (const auto &square : constraints.blocked)
+    {
+        if (!s.block(square.first, square.second))
+        {
+            return false;
+        }
+    }
+
+    // Pre-placed queens that attack each other (or sit on a blocked square)
+    // leave nothing to complete
+    for (const auto &queen : constraints.queens)
+    {
+        if (!s.fix(queen.first, queen.second))
+        {
+            return false;
+        }
+    }
+    s.listEmptyRows();
+
+    StatsTimer timer(stats);
+    auto takeFirst = [placement](const EmptyRowSearch &search)
+    {
+        std::copy(search.placed, search.placed + search.n, placement);
+        return true;
+    };
+    bool found = s.run(takeFirst);
+    if (nodes)
+    {
+        *nodes += s.nodes;
+    }
+    return found;
+}
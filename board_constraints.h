@@ -0,0 +1,37 @@
+#ifndef BOARD_CONSTRAINTS_H
+#define BOARD_CONSTRAINTS_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct SolverStats;
+
+// An N-queens completion problem: queens that are already on the board and
+// squares no queen may use. Squares are (row, col) pairs, 0-based.
+struct BoardConstraints
+{
+    int n = 8;
+    std::vector<std::pair<int, int>> queens;
+    std::vector<std::pair<int, int>> blocked;
+};
+
+// A solvable random instance: a min-conflicts solution of the n x n board
+// supplies `queens` pre-placed queens on random rows, and `blocked` random
+// squares off that solution are blocked. Counts are clamped to what fits.
+BoardConstraints randomConstraints(int n, int queens, int blocked, uint64_t seed);
+
+// True when placement[0..n) is a solution that keeps every pre-placed queen
+// and avoids every blocked square
+bool satisfiesConstraints(const BoardConstraints &constraints, const int *placement);
+
+// Reference search in solveQueens order: rows top to bottom, columns left to
+// right, no lookahead beyond the attack masks. Pre-placed rows are skipped and
+// blocked squares are masked out. Gives up (returns false) after nodeLimit
+// queens; n must be at most MAX_BOARD_SIZE. nodes (optional) is increased by
+// the number of queens placed; stats (optional) is added to, with depth
+// counted in rows.
+bool solveInRowOrder(const BoardConstraints &constraints, int *placement, uint64_t *nodes = nullptr,
+                     uint64_t nodeLimit = UINT64_MAX, SolverStats *stats = nullptr);
+
+#endif
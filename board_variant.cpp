@@ -0,0 +1,406 @@
+#include "board_variant.h"
+#include "solver_stats.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+const char *variantName(VariantKind kind)
+{
+    switch (kind)
+    {
+    case VARIANT_TOROIDAL:
+        return "toroidal";
+    case VARIANT_SUPERQUEENS:
+        return "superqueens";
+    default:
+        return "queens";
+    }
+}
+
+std::string describeVariant(const BoardVariant &variant)
+{
+    return std::string(variantName(variant.kind)) + " " + std::to_string(variant.rows) + "x" + std::to_string(variant.cols);
+}
+
+bool parseVariantKind(const std::string &text, VariantKind &kind)
+{
+    if (text == "queens")
+        kind = VARIANT_QUEENS;
+    else if (text == "torus")
+        kind = VARIANT_TOROIDAL;
+    else if (text == "super")
+        kind = VARIANT_SUPERQUEENS;
+    else
+        return false;
+    return true;
+}
+
+bool knownVariantCount(const BoardVariant &variant, uint64_t &count)
+{
+    static const uint64_t TOROIDAL[] = {0, 1, 0, 0, 0, 10, 0, 28, 0, 0, 0, 88, 0, 4524};
+    static const uint64_t SUPERQUEENS[] = {0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 4, 44, 156, 1876, 5180};
+    int n = variant.rows;
+    if (variant.rows != variant.cols)
+    {
+        return false;
+    }
+    if (variant.kind == VARIANT_QUEENS)
+    {
+        return knownSolutionCount(n, count);
+    }
+    if (variant.kind == VARIANT_TOROIDAL)
+    {
+        // No solution unless n is prime to 6 (Polya)
+        if (n % 2 == 0 || n % 3 == 0)
+            count = 0;
+        else if (n < static_cast<int>(sizeof(TOROIDAL) / sizeof(TOROIDAL[0])))
+            count = TOROIDAL[n];
+        else
+            return false;
+        return true;
+    }
+    if (n >= 1 && n < static_cast<int>(sizeof(SUPERQUEENS) / sizeof(SUPERQUEENS[0])))
+    {
+        count = SUPERQUEENS[n];
+        return true;
+    }
+    return false;
+}
+
+AttackTable::AttackTable(const BoardVariant &variant)
+    : board(variant), linesPerSquare((variant.rows + 7) / 8),
+      lines(static_cast<size_t>(variant.rows) * variant.cols * ((variant.rows + 7) / 8), AttackLine{})
+{
+    static const int KNIGHT[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+    int rows = board.rows;
+    int cols = board.cols;
+    for (int row = 0; row < rows; row++)
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            uint64_t *mask = lines[(row * cols + col) * linesPerSquare].rows;
+            mask[row] = boardMask(cols);
+            for (int r = 0; r < rows; r++)
+            {
+                mask[r] |= 1ULL << col;
+            }
+
+            if (board.kind == VARIANT_TOROIDAL)
+            {
+                // Walk both diagonals until they come back round; rows * cols
+                // steps covers every cycle length
+                for (int step = 1; step < rows * cols; step++)
+                {
+                    int r = (row + step) % rows;
+                    mask[r] |= 1ULL << ((col + step) % cols);
+                    mask[r] |= 1ULL << (((col - step) % cols + cols) % cols);
+                }
+            }
+            else
+            {
+                for (int r = 0; r < rows; r++)
+                {
+                    int distance = std::abs(r - row);
+                    if (col + distance < cols)
+                        mask[r] |= 1ULL << (col + distance);
+                    if (col - distance >= 0)
+                        mask[r] |= 1ULL << (col - distance);
+                }
+            }
+
+            if (board.kind == VARIANT_SUPERQUEENS)
+            {
+                for (const auto &move : KNIGHT)
+                {
+                    int r = row + move[0];
+                    int c = col + move[1];
+                    if (r >= 0 && r < rows && c >= 0 && c < cols)
+                        mask[r] |= 1ULL << c;
+                }
+            }
+        }
+    }
+}
+
+VariantBoard::VariantBoard(const AttackTable &table) : attackTable(&table)
+{
+    clear();
+}
+
+void VariantBoard::clear()
+{
+    std::fill(covered, covered + MAX_BOARD_SIZE, 0);
+    placed.clear();
+}
+
+void VariantBoard::place(int row, int col)
+{
+    const uint64_t *attacks = attackTable->attacks(row, col);
+    for (int r = 0; r < attackTable->rows(); r++)
+    {
+        covered[r] |= attacks[r];
+    }
+    placed.push_back({row, col});
+}
+
+void VariantBoard::remove(int row, int col)
+{
+    auto piece = std::find(placed.begin(), placed.end(), std::make_pair(row, col));
+    if (piece == placed.end())
+    {
+        return;
+    }
+    placed.erase(piece);
+
+    // Coverage is an OR of the pieces, so it cannot be undone one piece at a time
+    std::vector<std::pair<int, int>> rest;
+    rest.swap(placed);
+    clear();
+    for (const auto &other : rest)
+    {
+        place(other.first, other.second);
+    }
+}
+
+struct VariantSearch
+{
+    const AttackTable *table;
+    int rows;
+    uint64_t full;
+    std::vector<uint64_t> frames; // covered masks of every row, one frame per depth
+    int fixed[MAX_BOARD_SIZE];    // column of a piece already on the board, -1 for a free row
+    int *placement;
+    bool firstOnly;
+    uint64_t nodes;
+    uint64_t solutions;
+    SolverStats *stats;           // null when not instrumented
+};
+
+static bool searchVariant(VariantSearch &s, int row)
+{
+    if (row == s.rows)
+    {
+        s.solutions++;
+        if (s.stats)
+            STATS_ADD(*s.stats, solutions, 1);
+        return s.firstOnly;
+    }
+
+    const uint64_t *covered = &s.frames[static_cast<size_t>(row) * s.rows];
+    uint64_t *next = &s.frames[static_cast<size_t>(row + 1) * s.rows];
+    if (s.fixed[row] >= 0)
+    {
+        std::copy(covered + row + 1, covered + s.rows, next + row + 1);
+        s.placement[row] = s.fixed[row];
+        return searchVariant(s, row + 1);
+    }
+
+    uint64_t free = s.full & ~covered[row];
+    if (s.stats)
+    {
+        STATS_ADD(*s.stats, checks, 1);
+        STATS_ADD(*s.stats, prunes, free ? 0 : 1);
+    }
+    while (free)
+    {
+        uint64_t bit = free & (0 - free);
+        free ^= bit;
+        int col = lowestBit(bit);
+        s.nodes++;
+        if (s.stats)
+            STATS_NODE(*s.stats, row);
+
+        // Cover the rows below; a free row with nothing left ends the branch
+        const uint64_t *attacks = s.table->attacks(row, col);
+        bool dead = false;
+        for (int r = row + 1; r < s.rows; r++)
+        {
+            next[r] = covered[r] | attacks[r];
+            if (next[r] == s.full && s.fixed[r] < 0)
+            {
+                dead = true;
+                break;
+            }
+        }
+        if (dead)
+        {
+            if (s.stats)
+                STATS_ADD(*s.stats, prunes, 1);
+            continue;
+        }
+        s.placement[row] = col;
+        if (searchVariant(s, row + 1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Searches below `start`; false when its pieces share a row or attack each other
+static bool runVariantSearch(const VariantBoard &start, int *placement, bool firstOnly, uint64_t *nodes,
+                             SolverStats *stats, uint64_t &solutions)
+{
+    const AttackTable &table = start.table();
+    VariantSearch s;
+    s.table = &table;
+    s.rows = table.rows();
+    s.full = boardMask(table.cols());
+    s.frames.assign(static_cast<size_t>(s.rows + 1) * s.rows, 0);
+    s.placement = placement;
+    s.firstOnly = firstOnly;
+    s.nodes = 0;
+    s.solutions = 0;
+    s.stats = STATS_ENABLED ? stats : nullptr;
+    std::fill(s.fixed, s.fixed + MAX_BOARD_SIZE, -1);
+
+    for (const auto &piece : start.pieces())
+    {
+        if (s.fixed[piece.first] >= 0)
+            return false;
+        s.fixed[piece.first] = piece.second;
+        const uint64_t *attacks = table.attacks(piece.first, piece.second);
+        for (const auto &other : start.pieces())
+        {
+            if (other != piece && (attacks[other.first] >> other.second) & 1ULL)
+                return false;
+        }
+    }
+    for (int row = 0; row < s.rows; row++)
+    {
+        s.frames[row] = s.fixed[row] >= 0 ? 0 : start.freeColumns(row) ^ s.full;
+    }
+
+    StatsTimer timer(s.stats);
+    searchVariant(s, 0);
+    if (nodes)
+    {
+        *nodes += s.nodes;
+    }
+    solutions = s.solutions;
+    return true;
+}
+
+bool completeVariant(const VariantBoard &start, int *placement, uint64_t *nodes, SolverStats *stats)
+{
+    uint64_t solutions = 0;
+    return runVariantSearch(start, placement, true, nodes, stats, solutions) && solutions > 0;
+}
+
+uint64_t countVariantCompletions(const VariantBoard &start, uint64_t *nodes, SolverStats *stats)
+{
+    int placement[MAX_BOARD_SIZE];
+    uint64_t solutions = 0;
+    runVariantSearch(start, placement, false, nodes, stats, solutions);
+    return solutions;
+}
+
+bool solveVariant(const BoardVariant &variant, int *placement, uint64_t *nodes, SolverStats *stats)
+{
+    if (!variant.valid())
+    {
+        return false;
+    }
+    if (variant.isClassic())
+    {
+        return solveQueens(variant.rows, placement, nodes, threadArena(), stats);
+    }
+    AttackTable table(variant);
+    VariantBoard empty(table);
+    return completeVariant(empty, placement, nodes, stats);
+}
+
+// Legal placements of the first `depth` rows of an empty board, in order
+static void expandVariantPrefixes(const AttackTable &table, VariantBoard &board, int row, int depth,
+                                  std::vector<int> &prefix, std::vector<std::vector<int>> &out, uint64_t &nodes)
+{
+    if (row == depth)
+    {
+        out.push_back(prefix);
+        return;
+    }
+    uint64_t free = board.freeColumns(row);
+    while (free)
+    {
+        int col = lowestBit(free);
+        free &= free - 1;
+        nodes++;
+        board.place(row, col);
+        prefix.push_back(col);
+        expandVariantPrefixes(table, board, row + 1, depth, prefix, out, nodes);
+        prefix.pop_back();
+        board.remove(row, col);
+    }
+}
+
+// One cache line per worker so the counters never share a line
+struct alignas(64) VariantCounters
+{
+    uint64_t solutions = 0;
+    uint64_t nodes = 0;
+    SolverStats stats;
+};
+
+ParallelCountResult countVariantSolutions(const BoardVariant &variant, int prefixDepth, int threadCount, SolverStats *stats)
+{
+    ParallelCountResult result = {0, 0, 0, 0};
+    if (!variant.valid())
+    {
+        return result;
+    }
+    if (variant.isClassic())
+    {
+        return countSolutionsParallel(variant.rows, prefixDepth, threadCount, ENGINE_AUTO, stats);
+    }
+
+    AttackTable table(variant);
+    VariantBoard board(table);
+    std::vector<int> prefix;
+    std::vector<std::vector<int>> prefixes;
+    expandVariantPrefixes(table, board, 0, std::max(0, std::min(prefixDepth, variant.rows)), prefix, prefixes,
+                          result.nodes);
+
+    WorkStealingPool pool(threadCount);
+    std::vector<VariantCounters> counters(pool.threadCount());
+    bool instrumented = STATS_ENABLED && stats;
+    for (const std::vector<int> &columns : prefixes)
+    {
+        pool.submit([&table, &columns, instrumented, &counters](int worker)
+                    {
+                        VariantCounters &local = counters[worker];
+                        VariantBoard start(table);
+                        for (int row = 0; row < static_cast<int>(columns.size()); row++)
+                            start.place(row, columns[row]);
+                        local.solutions += countVariantCompletions(start, &local.nodes, instrumented ? &local.stats : nullptr); });
+    }
+    pool.wait();
+
+    for (const VariantCounters &local : counters)
+    {
+        result.solutions += local.solutions;
+        result.nodes += local.nodes;
+        if (instrumented)
+            stats->merge(local.stats);
+    }
+    result.tasks = static_cast<int>(prefixes.size());
+    result.threads = pool.threadCount();
+    return result;
+}
+
+bool verifyVariantPlacement(const BoardVariant &variant, const int *placement)
+{
+    if (!variant.valid())
+    {
+        return false;
+    }
+    AttackTable table(variant);
+    VariantBoard board(table);
+    for (int row = 0; row < variant.rows; row++)
+    {
+        if (placement[row] < 0 || placement[row] >= variant.cols || !board.canPlace(row, placement[row]))
+            return false;
+        board.place(row, placement[row]);
+    }
+    return true;
+}
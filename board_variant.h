@@ -0,0 +1,115 @@
+#ifndef BOARD_VARIANT_H
+#define BOARD_VARIANT_H
+
+#include "parallel_counter.h"
+#include "solver.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The pieces and the board of an N-queens variant
+enum VariantKind
+{
+    VARIANT_QUEENS,      // ordinary queens
+    VARIANT_TOROIDAL,    // queens whose diagonals wrap around the edges
+    VARIANT_SUPERQUEENS, // queens that also move like a knight
+    VARIANT_KIND_COUNT
+};
+
+// A variant on a rows x cols board, rows <= cols, so a solution puts one piece
+// on every row (a taller board is the same problem transposed). The classic
+// puzzle is {VARIANT_QUEENS, n, n}.
+struct BoardVariant
+{
+    VariantKind kind = VARIANT_QUEENS;
+    int rows = 8;
+    int cols = 8;
+
+    bool isClassic() const { return kind == VARIANT_QUEENS && rows == cols; }
+    bool valid() const { return rows >= 1 && rows <= cols && cols <= MAX_BOARD_SIZE; }
+};
+
+const char *variantName(VariantKind kind);
+
+// "superqueens 10x10", "queens 6x8"
+std::string describeVariant(const BoardVariant &variant);
+
+// "queens" | "torus" | "super"; false for anything else
+bool parseVariantKind(const std::string &text, VariantKind &kind);
+
+// Published counts for square boards (toroidal: OEIS A051906, superqueens:
+// A051223, queens: knownSolutionCount); false when unknown
+bool knownVariantCount(const BoardVariant &variant, uint64_t &count);
+
+// One cache line of row masks
+struct alignas(64) AttackLine
+{
+    uint64_t rows[8];
+};
+
+// Every square a piece attacks or stands on, for each square of the board, as
+// one column mask per row. Built once per variant; each square's masks start
+// on their own cache line (an 8-row board is exactly one line per square).
+class AttackTable
+{
+public:
+    explicit AttackTable(const BoardVariant &variant = BoardVariant());
+
+    const BoardVariant &variant() const { return board; }
+    int rows() const { return board.rows; }
+    int cols() const { return board.cols; }
+
+    // attacks(row, col)[r]: columns of row r covered by a piece on (row, col)
+    const uint64_t *attacks(int row, int col) const { return lines[(row * board.cols + col) * linesPerSquare].rows; }
+
+private:
+    BoardVariant board;
+    int linesPerSquare;
+    std::vector<AttackLine> lines;
+};
+
+// Pieces on a variant board, with the squares they cover kept per row so that
+// testing a square is one AND. Placing costs one OR per row; removing rebuilds
+// the masks from the remaining pieces.
+class VariantBoard
+{
+public:
+    explicit VariantBoard(const AttackTable &table);
+
+    const AttackTable &table() const { return *attackTable; }
+    const std::vector<std::pair<int, int>> &pieces() const { return placed; }
+
+    void clear();
+    bool canPlace(int row, int col) const { return !(covered[row] & (1ULL << col)); }
+    void place(int row, int col);
+    void remove(int row, int col);
+
+    // Columns of `row` no piece covers
+    uint64_t freeColumns(int row) const { return boardMask(attackTable->cols()) & ~covered[row]; }
+
+private:
+    const AttackTable *attackTable;
+    uint64_t covered[MAX_BOARD_SIZE];
+    std::vector<std::pair<int, int>> placed;
+};
+
+// Row-by-row search over an attack table; rows that already hold a piece on
+// `start` are kept. placement[row] = col for every row. nodes (optional) is
+// increased by the pieces placed; stats (optional) is added to.
+bool completeVariant(const VariantBoard &start, int *placement, uint64_t *nodes = nullptr, SolverStats *stats = nullptr);
+uint64_t countVariantCompletions(const VariantBoard &start, uint64_t *nodes = nullptr, SolverStats *stats = nullptr);
+
+// The solvers for a variant descriptor. The classic board goes to
+// solveQueens/countSolutionsParallel; anything else builds an attack table and
+// runs the table search, counting prefixDepth-row prefixes on the
+// work-stealing pool.
+bool solveVariant(const BoardVariant &variant, int *placement, uint64_t *nodes = nullptr, SolverStats *stats = nullptr);
+ParallelCountResult countVariantSolutions(const BoardVariant &variant, int prefixDepth = 2, int threadCount = 0,
+                                          SolverStats *stats = nullptr);
+
+// True when no two of the pieces placement[0..rows) attack each other
+bool verifyVariantPlacement(const BoardVariant &variant, const int *placement);
+
+#endif
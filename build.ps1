@@ -26,6 +26,7 @@ param(
 # Configuration
 $ProjectName = "3D-8-Queens-OpenGL"
 $SourceFile = "main.cpp"
+$SolverSources = @("solver.cpp", "parallel_counter.cpp", "work_stealing_pool.cpp", "symmetry.cpp", "min_conflicts.cpp", "placement_writer.cpp", "constructive_solver.cpp", "solve_strategy.cpp", "completion_oracle.cpp", "viability_heatmap.cpp", "stepwise_solver.cpp", "simd_counter.cpp", "fixed_solver.cpp", "solution_archive.cpp", "solution_index.cpp", "solution_sampler.cpp", "puzzle_generator.cpp", "board_constraints.cpp", "dlx_solver.cpp", "propagation_solver.cpp", "solver_farm.cpp", "solver_stats.cpp", "search_trace.cpp", "board_variant.cpp", "cube_solver.cpp", "threat_map.cpp", "empty_row_search.cpp", "binary_file.cpp")
 $OutputFile = "main.exe"
 $MakeCommand = "g++"
 
@@ -199,7 +200,7 @@ function Build-Project {
     )
 
     # Construct compile command
-    $compileCmd = "$MakeCommand $SourceFile -o $OutputFile $includeFlags $libPathFlags $libraries -std=c++17 -Wall"
+    $compileCmd = "$MakeCommand $SourceFile $SolverSources -o $OutputFile $includeFlags $libPathFlags $libraries -std=c++17 -Wall"
 
     Write-ColorOutput "Compiling..." $Cyan
     Write-ColorOutput "Command: $compileCmd" $White
@@ -1,3 +1,3 @@
 #!/bin/bash
 cd "$(dirname "$0")"
-g++ main.cpp -o main -I/home/leul/include/stb -I/home/leul/include/tinyobjloader -I/usr/include/freetype2 -I/usr/include/AL -lglut -lGLU -lGL -lfreetype -lopenal && ./main
\ No newline at end of file
+g++ main.cpp solver.cpp parallel_counter.cpp work_stealing_pool.cpp symmetry.cpp min_conflicts.cpp placement_writer.cpp constructive_solver.cpp solve_strategy.cpp completion_oracle.cpp viability_heatmap.cpp stepwise_solver.cpp simd_counter.cpp fixed_solver.cpp solution_archive.cpp solution_index.cpp solution_sampler.cpp puzzle_generator.cpp board_constraints.cpp dlx_solver.cpp propagation_solver.cpp solver_farm.cpp solver_stats.cpp search_trace.cpp board_variant.cpp cube_solver.cpp threat_map.cpp empty_row_search.cpp binary_file.cpp -o main -pthread -I/home/leul/include/stb -I/home/leul/include/tinyobjloader -I/usr/include/freetype2 -I/usr/include/AL -lglut -lGLU -lGL -lfreetype -lopenal && ./main
\ No newline at end of file
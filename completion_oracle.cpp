@@ -0,0 +1,101 @@
+#include "completion_oracle.h"
+
+#include <cstddef>
+
+CompletionOracle::CompletionOracle(int capacityLog2)
+    : table(std::size_t(1) << capacityLog2), mask((uint64_t(1) << capacityLog2) - 1)
+{
+    clear();
+}
+
+void CompletionOracle::clear()
+{
+    for (Entry &entry : table)
+    {
+        entry.row = -1;
+    }
+    hits = 0;
+    misses = 0;
+}
+
+static inline uint64_t mix(uint64_t hash, uint64_t value)
+{
+    hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return hash * 0xFF51AFD7ED558CCDULL;
+}
+
+CompletionOracle::Entry &CompletionOracle::slotFor(const Bitboard &board, int row)
+{
+    uint64_t hash = mix(static_cast<uint64_t>(row) << 8 | static_cast<uint64_t>(board.size), board.rows);
+    hash = mix(hash, board.cols);
+    hash = mix(hash, board.diagonals[0]);
+    hash = mix(hash, board.diagonals[1]);
+    hash = mix(hash, board.antiDiagonals[0]);
+    hash = mix(hash, board.antiDiagonals[1]);
+    return table[(hash ^ (hash >> 29)) & mask];
+}
+
+bool CompletionOracle::matches(const Entry &entry, const Bitboard &board, int row)
+{
+    return entry.row == row && entry.size == board.size && entry.rows == board.rows && entry.cols == board.cols &&
+           entry.diagonals[0] == board.diagonals[0] && entry.diagonals[1] == board.diagonals[1] &&
+           entry.antiDiagonals[0] == board.antiDiagonals[0] && entry.antiDiagonals[1] == board.antiDiagonals[1];
+}
+
+uint64_t CompletionOracle::search(Bitboard &board, int row)
+{
+    int n = board.size;
+    while (row < n && ((board.rows >> row) & 1ULL))
+    {
+        row++;
+    }
+    if (row == n)
+    {
+        return 1; // every row holds a queen
+    }
+
+    Entry &slot = slotFor(board, row);
+    if (matches(slot, board, row))
+    {
+        hits++;
+        return slot.count;
+    }
+    misses++;
+
+    uint64_t count = 0;
+    uint64_t free = boardMask(n) & ~board.cols;
+    while (free)
+    {
+        int col = lowestBit(free);
+        free &= free - 1;
+        if (board.canPlace(row, col))
+        {
+            board.place(row, col);
+            count += search(board, row + 1);
+            board.remove(row, col);
+        }
+    }
+
+    // The recursion may have reused the slot; write the whole entry again
+    Entry &entry = slotFor(board, row);
+    entry.rows = board.rows;
+    entry.cols = board.cols;
+    entry.diagonals[0] = board.diagonals[0];
+    entry.diagonals[1] = board.diagonals[1];
+    entry.antiDiagonals[0] = board.antiDiagonals[0];
+    entry.antiDiagonals[1] = board.antiDiagonals[1];
+    entry.count = count;
+    entry.row = static_cast<int8_t>(row);
+    entry.size = static_cast<int8_t>(n);
+    return count;
+}
+
+uint64_t CompletionOracle::completions(const Bitboard &board)
+{
+    if (board.size <= 0 || board.size > MAX_BOARD_SIZE)
+    {
+        return 0;
+    }
+    Bitboard scratch = board;
+    return search(scratch, 0);
+}
@@ -0,0 +1,47 @@
+#ifndef COMPLETION_ORACLE_H
+#define COMPLETION_ORACLE_H
+
+#include "solver.h"
+
+#include <cstdint>
+#include <vector>
+
+// Answers "how many solutions extend this partial board?" for boards whose
+// queens sit on arbitrary rows. Empty rows are filled top to bottom, and every
+// subproblem (next row, occupied rows, columns and diagonals) is memoized in a
+// fixed-size hash table, so a board seen before in the session costs one
+// lookup. When two states hash to the same slot the newer one wins.
+class CompletionOracle
+{
+public:
+    // The table holds 2^capacityLog2 entries
+    explicit CompletionOracle(int capacityLog2 = 16);
+
+    uint64_t completions(const Bitboard &board);
+
+    void clear();
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+private:
+    struct Entry
+    {
+        uint64_t rows;
+        uint64_t cols;
+        uint64_t diagonals[2];
+        uint64_t antiDiagonals[2];
+        uint64_t count;
+        int8_t row;  // next row to fill, -1 for an empty slot
+        int8_t size; // board size, so one oracle can serve several sizes
+    };
+
+    uint64_t search(Bitboard &board, int row);
+    Entry &slotFor(const Bitboard &board, int row);
+    static bool matches(const Entry &entry, const Bitboard &board, int row);
+
+    std::vector<Entry> table;
+    uint64_t mask;
+};
+
+#endif
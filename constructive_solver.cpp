@@ -0,0 +1,70 @@
+#include "constructive_solver.h"
+
+bool hasConstruction(int n)
+{
+    return n >= 1 && n != 2 && n != 3;
+}
+
+// The 1-based column sequence is the even numbers followed by the odd ones:
+//   n mod 6 not 2 or 3: 2 4 ... | 1 3 ...
+//   n mod 6 == 2:       2 4 ... | 3 1 7 9 ... 5    (swap 1 and 3, move 5 last)
+//   n mod 6 == 3:       4 6 ... 2 | 5 7 ... 1 3    (move 2, then 1 and 3, last)
+int constructedColumn(int n, int row)
+{
+    int evens = n / 2;
+    int odds = n - evens;
+    int column; // 1-based
+
+    if (row < evens)
+    {
+        if (n % 6 == 3)
+            column = row + 1 < evens ? 2 * (row + 2) : 2;
+        else
+            column = 2 * (row + 1);
+    }
+    else
+    {
+        int i = row - evens; // position within the odd list
+        if (n % 6 == 2)
+        {
+            if (i == 0)
+                column = 3;
+            else if (i == 1)
+                column = 1;
+            else if (i == odds - 1)
+                column = 5;
+            else
+                column = 2 * (i + 1) + 1; // 7, 9, ...
+        }
+        else if (n % 6 == 3)
+        {
+            if (i == odds - 2)
+                column = 1;
+            else if (i == odds - 1)
+                column = 3;
+            else
+                column = 2 * (i + 2) + 1; // 5, 7, ...
+        }
+        else
+        {
+            column = 2 * i + 1;
+        }
+    }
+    return column - 1;
+}
+
+bool constructPlacement(int n, std::vector<int> &placement)
+{
+    if (!hasConstruction(n))
+    {
+        placement.clear();
+        return false;
+    }
+
+    placement.resize(n);
+    for (int row = 0; row < n; row++)
+    {
+        placement[row] = constructedColumn(n, row);
+    }
+    return true;
+}
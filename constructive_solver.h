@@ -0,0 +1,19 @@
+#ifndef CONSTRUCTIVE_SOLVER_H
+#define CONSTRUCTIVE_SOLVER_H
+
+#include <vector>
+
+// Closed-form placements from the classic explicit construction, which splits
+// on n mod 6. Works for every n except 2 and 3, in O(1) per row.
+
+// True when the construction applies (n >= 1, n != 2, n != 3)
+bool hasConstruction(int n);
+
+// Column (0-based) of the queen in `row` for an n x n board. Rows can be
+// generated one at a time, so huge boards can be streamed without storing them.
+int constructedColumn(int n, int row);
+
+// Fills placement[row] = col for the whole board; false when n has no solution
+bool constructPlacement(int n, std::vector<int> &placement);
+
+#endif
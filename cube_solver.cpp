@@ -0,0 +1,592 @@
+#include "cube_solver.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+// Layers z - k, z and z + k of a vertical line, for every distance k and layer
+// z; row k = 0 is the queen's own line, which loses every layer
+struct LayerSpreads
+{
+    uint32_t masks[MAX_CUBE_SIZE][MAX_CUBE_SIZE];
+
+    LayerSpreads()
+    {
+        for (int k = 0; k < MAX_CUBE_SIZE; k++)
+        {
+            for (int z = 0; z < MAX_CUBE_SIZE; z++)
+            {
+                uint32_t mask = 1U << z;
+                if (z + k < MAX_CUBE_SIZE)
+                    mask |= 1U << (z + k);
+                if (z - k >= 0)
+                    mask |= 1U << (z - k);
+                masks[k][z] = k == 0 ? ~0U : mask;
+            }
+        }
+    }
+};
+
+static const LayerSpreads SPREADS;
+static const int COMPASS[8][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+void coverCube(int n, uint32_t *free, int layer, int row, int col)
+{
+    free[row * n + col] = 0;
+    for (const auto &direction : COMPASS)
+    {
+        int r = row + direction[0];
+        int c = col + direction[1];
+        for (int k = 1; r >= 0 && r < n && c >= 0 && c < n; k++)
+        {
+            free[r * n + c] &= ~SPREADS.masks[k][layer];
+            r += direction[0];
+            c += direction[1];
+        }
+    }
+}
+
+CubeBoard::CubeBoard(int size) : n(std::max(1, std::min(size, MAX_CUBE_SIZE)))
+{
+    clear();
+}
+
+void CubeBoard::clear()
+{
+    uint32_t all = n >= 32 ? ~0U : (1U << n) - 1;
+    free.assign(static_cast<size_t>(n) * n, all);
+    placed.clear();
+}
+
+void CubeBoard::place(int layer, int row, int col)
+{
+    coverCube(n, free.data(), layer, row, col);
+    placed.push_back(CubeQueen{layer, row, col});
+}
+
+void CubeBoard::remove(int layer, int row, int col)
+{
+    auto queen = std::find_if(placed.begin(), placed.end(), [&](const CubeQueen &q)
+                              { return q.layer == layer && q.row == row && q.col == col; });
+    if (queen == placed.end())
+    {
+        return;
+    }
+    placed.erase(queen);
+
+    // Cleared bits cannot be told apart by queen, so the rest are covered again
+    std::vector<CubeQueen> rest;
+    rest.swap(placed);
+    clear();
+    for (const CubeQueen &other : rest)
+    {
+        place(other.layer, other.row, other.col);
+    }
+}
+
+bool knownCubeMaximum(int n, int &queens)
+{
+    static const int MAXIMUM[] = {0, 1, 1, 4, 7, 13, 21, 32, 48, 67, 91, 121};
+    if (n < 1 || n >= static_cast<int>(sizeof(MAXIMUM) / sizeof(MAXIMUM[0])))
+    {
+        return false;
+    }
+    queens = MAXIMUM[n];
+    return true;
+}
+
+// Two queens share a line when every coordinate that differs differs by the
+// same amount
+static bool cubeAttacks(const CubeQueen &a, const CubeQueen &b)
+{
+    int steps[3] = {std::abs(a.layer - b.layer), std::abs(a.row - b.row), std::abs(a.col - b.col)};
+    int step = std::max(steps[0], std::max(steps[1], steps[2]));
+    for (int d : steps)
+    {
+        if (d != 0 && d != step)
+            return false;
+    }
+    return true;
+}
+
+bool verifyCube(int n, const std::vector<CubeQueen> &queens)
+{
+    for (size_t i = 0; i < queens.size(); i++)
+    {
+        const CubeQueen &a = queens[i];
+        if (a.layer < 0 || a.layer >= n || a.row < 0 || a.row >= n || a.col < 0 || a.col >= n)
+            return false;
+        for (size_t j = i + 1; j < queens.size(); j++)
+        {
+            if (cubeAttacks(a, queens[j]))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Upper bound on the queens the open vertical lines can still take: a row
+// of lines holds at most one queen per layer (they would share a layer row)
+// and one per open line; the same goes for columns. The smaller sum wins.
+static bool canReach(int n, const uint32_t *free, int missing)
+{
+    int byRows = 0;
+    int byCols = 0;
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t rowLayers = 0;
+        uint32_t colLayers = 0;
+        int rowOpen = 0;
+        int colOpen = 0;
+        for (int j = 0; j < n; j++)
+        {
+            uint32_t inRow = free[i * n + j];
+            uint32_t inCol = free[j * n + i];
+            rowLayers |= inRow;
+            colLayers |= inCol;
+            rowOpen += inRow != 0;
+            colOpen += inCol != 0;
+        }
+        byRows += std::min(rowOpen, __builtin_popcount(rowLayers));
+        byCols += std::min(colOpen, __builtin_popcount(colLayers));
+    }
+    return std::min(byRows, byCols) >= missing;
+}
+
+// Open line with the fewest free layers, -1 when every line is closed
+static int chooseLine(int n, const uint32_t *free)
+{
+    int best = -1;
+    int fewest = MAX_CUBE_SIZE + 1;
+    for (int line = 0; line < n * n; line++)
+    {
+        int layers = __builtin_popcount(free[line]);
+        if (layers > 0 && layers < fewest)
+        {
+            best = line;
+            fewest = layers;
+            if (layers == 1)
+                break;
+        }
+    }
+    return best;
+}
+
+// A search position: the free layers of every line and the queens so far
+struct CubeState
+{
+    std::vector<uint32_t> free;
+    std::vector<CubeQueen> queens;
+};
+
+// Appends the children of `state` in the order the search tries them; none
+// when the target is out of reach from it
+static void expandCube(int n, int target, const CubeState &state, std::vector<CubeState> &out, uint64_t &nodes)
+{
+    if (!canReach(n, state.free.data(), target - static_cast<int>(state.queens.size())))
+    {
+        return;
+    }
+    int line = chooseLine(n, state.free.data());
+    if (line < 0)
+    {
+        return;
+    }
+    uint32_t layers = state.free[line];
+    while (layers)
+    {
+        int layer = __builtin_ctz(layers);
+        layers &= layers - 1;
+        CubeState child = state;
+        coverCube(n, child.free.data(), layer, line / n, line % n);
+        child.queens.push_back(CubeQueen{layer, line / n, line % n});
+        nodes++;
+        out.push_back(child);
+    }
+    CubeState empty = state;
+    empty.free[line] = 0;
+    out.push_back(empty);
+}
+
+struct CubeSearch
+{
+    int n;
+    int cells;
+    int target;
+    std::vector<uint32_t> frames; // free layers of every line, one frame per depth
+    std::vector<CubeQueen> queens;
+    uint64_t nodes;
+    uint64_t unreported;
+    uint64_t limit;
+    std::atomic<bool> *stop;      // set by the first task to succeed or by the node limit
+    std::atomic<uint64_t> *total; // nodes of every task, reported in batches
+    bool limitHit;
+
+    // Adds this task's recent nodes to the total; true once over the limit
+    bool report()
+    {
+        uint64_t sum = total->fetch_add(unreported) + unreported;
+        unreported = 0;
+        if (sum >= limit)
+        {
+            limitHit = true;
+            stop->store(true);
+        }
+        return limitHit;
+    }
+
+    bool search(int depth)
+    {
+        if (static_cast<int>(queens.size()) == target)
+        {
+            return true;
+        }
+        if (stop->load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        const uint32_t *free = &frames[static_cast<size_t>(depth) * cells];
+        if (!canReach(n, free, target - static_cast<int>(queens.size())))
+        {
+            return false;
+        }
+        int line = chooseLine(n, free);
+        if (line < 0)
+        {
+            return false;
+        }
+
+        uint32_t *next = &frames[static_cast<size_t>(depth + 1) * cells];
+        uint32_t layers = free[line];
+        while (layers)
+        {
+            int layer = __builtin_ctz(layers);
+            layers &= layers - 1;
+            std::copy(free, free + cells, next);
+            coverCube(n, next, layer, line / n, line % n);
+            queens.push_back(CubeQueen{layer, line / n, line % n});
+            nodes++;
+            if (++unreported == 4096 && report())
+            {
+                return false;
+            }
+            if (search(depth + 1))
+            {
+                return true;
+            }
+            queens.pop_back();
+        }
+
+        // The line stays empty; the bound above rejects this when the
+        // target needs every line
+        std::copy(free, free + cells, next);
+        next[line] = 0;
+        return search(depth + 1);
+    }
+};
+
+// The 13 lines through a square, one direction each
+static const int CUBE_LINES[13][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 0}, {1, -1, 0}, {1, 0, 1}, {1, 0, -1},
+                                      {0, 1, 1}, {0, 1, -1}, {1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1}};
+static const uint64_t FIRST_ROUND_BUDGET = 1 << 20;
+static const uint64_t WALK_TABU_MOVES = 5; // a square a queen just left stays closed this long
+
+static CubeQueen cubeSquare(int n, int cell)
+{
+    return CubeQueen{cell / (n * n), cell / n % n, cell % n};
+}
+
+// Adds delta to the count of every square a queen on `cell` attacks
+static void countAttacks(int n, std::vector<int> &attacks, int cell, int delta)
+{
+    CubeQueen queen = cubeSquare(n, cell);
+    for (const auto &line : CUBE_LINES)
+    {
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            int z = queen.layer + sign * line[0];
+            int r = queen.row + sign * line[1];
+            int c = queen.col + sign * line[2];
+            while (z >= 0 && z < n && r >= 0 && r < n && c >= 0 && c < n)
+            {
+                attacks[(z * n + r) * n + c] += delta;
+                z += sign * line[0];
+                r += sign * line[1];
+                c += sign * line[2];
+            }
+        }
+    }
+}
+
+// splitmix64
+static uint64_t nextRandom(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static int randomBelow(uint64_t &state, int bound)
+{
+    return static_cast<int>((nextRandom(state) >> 32) * static_cast<uint64_t>(bound) >> 32);
+}
+
+// Min-conflicts walk with `target` queens: fill greedily, then move a random
+// attacked queen to the least attacked free square until none is attacked.
+// Mirrored walks move a queen and its reflection through the centre together
+// (plus a fixed queen on the centre square for an odd target on an odd cube).
+static bool walkCube(int n, int target, uint64_t seed, uint64_t maxMoves, const std::atomic<bool> &stop,
+                     std::vector<CubeQueen> &queens, uint64_t &moves)
+{
+    int cells = n * n * n;
+    bool mirrored = target % 2 == 0 || n % 2 == 1;
+    bool centred = mirrored && target % 2 == 1;
+    int pieces = mirrored ? target / 2 : target;
+    std::vector<int> attacks(cells, 0);
+    if (centred)
+    {
+        countAttacks(n, attacks, cells / 2, 1);
+    }
+
+    // Squares a piece may use: with mirroring, the lower square of each pair
+    // that neither attacks its reflection nor sits in line with the centre
+    std::vector<int> squares;
+    for (int cell = 0; cell < cells; cell++)
+    {
+        int reflection = cells - 1 - cell;
+        if (!mirrored)
+            squares.push_back(cell);
+        else if (cell < reflection && !cubeAttacks(cubeSquare(n, cell), cubeSquare(n, reflection)) && attacks[cell] == 0)
+            squares.push_back(cell);
+    }
+    if (static_cast<int>(squares.size()) < pieces)
+    {
+        return false;
+    }
+
+    std::vector<char> occupied(cells, 0);
+    std::vector<uint64_t> closedUntil(cells, 0);
+    std::vector<int> placed;
+    std::vector<int> attacked;
+    auto cost = [&](int cell)
+    { return attacks[cell] + (mirrored ? attacks[cells - 1 - cell] : 0); };
+    auto put = [&](int cell, int delta)
+    {
+        countAttacks(n, attacks, cell, delta);
+        if (mirrored)
+            countAttacks(n, attacks, cells - 1 - cell, delta);
+        occupied[cell] = delta > 0;
+    };
+    // Least attacked open square, ties broken at random; -1 when none is open
+    auto choose = [&](uint64_t &random)
+    {
+        int best = -1;
+        int bestCost = 0;
+        int ties = 0;
+        for (int cell : squares)
+        {
+            if (occupied[cell] || closedUntil[cell] > moves)
+                continue;
+            int c = cost(cell);
+            if (best < 0 || c < bestCost)
+            {
+                best = cell;
+                bestCost = c;
+                ties = 1;
+            }
+            else if (c == bestCost && randomBelow(random, ++ties) == 0)
+            {
+                best = cell;
+            }
+        }
+        return best;
+    };
+
+    uint64_t random = seed;
+    for (int i = 0; i < pieces; i++)
+    {
+        placed.push_back(choose(random));
+        put(placed.back(), 1);
+    }
+    while (true)
+    {
+        attacked.clear();
+        for (int i = 0; i < pieces; i++)
+        {
+            if (cost(placed[i]) > 0)
+                attacked.push_back(i);
+        }
+        if (attacked.empty())
+        {
+            break;
+        }
+        if (moves >= maxMoves || ((moves & 255) == 0 && stop.load(std::memory_order_relaxed)))
+        {
+            return false;
+        }
+        int piece = attacked[randomBelow(random, static_cast<int>(attacked.size()))];
+        int from = placed[piece];
+        put(from, -1);
+        closedUntil[from] = moves + 1 + WALK_TABU_MOVES;
+        int to = choose(random);
+        placed[piece] = to >= 0 ? to : from;
+        put(placed[piece], 1);
+        moves++;
+    }
+
+    queens.clear();
+    if (centred)
+        queens.push_back(cubeSquare(n, cells / 2));
+    for (int cell : placed)
+    {
+        queens.push_back(cubeSquare(n, cell));
+        if (mirrored)
+            queens.push_back(cubeSquare(n, cells - 1 - cell));
+    }
+    return true;
+}
+
+CubeSolveResult solveCube(const CubeSolveOptions &options)
+{
+    CubeSolveResult result;
+    int n = options.n;
+    if (n < 1 || n > MAX_CUBE_SIZE)
+    {
+        return result;
+    }
+    int known = 0;
+    result.target = options.target >= 0 ? options.target : (knownCubeMaximum(n, known) ? known : n * n);
+    int cells = n * n;
+    if (result.target > cells)
+    {
+        result.exhausted = true; // one queen per vertical line at most
+        return result;
+    }
+
+    CubeState root;
+    CubeBoard empty(n);
+    for (int row = 0; row < n; row++)
+    {
+        for (int col = 0; col < n; col++)
+            root.free.push_back(empty.freeLayers(row, col));
+    }
+
+    // Breadth-first over the first decisions; a target met on the way is done
+    std::vector<CubeState> prefixes(1, root);
+    for (int level = 0; level < options.prefixDepth; level++)
+    {
+        std::vector<CubeState> next;
+        for (const CubeState &state : prefixes)
+        {
+            if (static_cast<int>(state.queens.size()) == result.target)
+            {
+                result.found = true;
+                result.queens = state.queens;
+                return result;
+            }
+            expandCube(n, result.target, state, next, result.nodes);
+        }
+        prefixes.swap(next);
+    }
+
+    WorkStealingPool pool(options.threads);
+    result.tasks = static_cast<int>(prefixes.size());
+    result.threads = pool.threadCount();
+    std::mutex resultLock;
+    uint64_t budget = FIRST_ROUND_BUDGET;
+    while (result.nodes < options.nodeLimit)
+    {
+        // The exact search starts over each round with twice the budget
+        result.rounds++;
+        uint64_t roundLimit = std::min(budget, options.nodeLimit - result.nodes);
+        std::atomic<bool> stop(false);
+        std::atomic<uint64_t> total(0);
+        std::atomic<bool> limitHit(false);
+        for (const CubeState &prefix : prefixes)
+        {
+            pool.submit([&, n, cells](int)
+                        {
+                            if (stop.load())
+                                return;
+                            CubeSearch search;
+                            search.n = n;
+                            search.cells = cells;
+                            search.target = result.target;
+                            search.frames.assign(static_cast<size_t>(cells + 1) * cells, 0);
+                            std::copy(prefix.free.begin(), prefix.free.end(), search.frames.begin());
+                            search.queens = prefix.queens;
+                            search.nodes = 0;
+                            search.unreported = 0;
+                            search.limit = roundLimit;
+                            search.stop = &stop;
+                            search.total = &total;
+                            search.limitHit = false;
+                            bool found = search.search(0);
+                            search.report();
+                            if (search.limitHit)
+                                limitHit.store(true);
+                            if (found)
+                            {
+                                std::lock_guard<std::mutex> guard(resultLock);
+                                if (!result.found)
+                                {
+                                    result.found = true;
+                                    result.queens = search.queens;
+                                }
+                                stop.store(true);
+                            } });
+        }
+        pool.wait();
+        result.nodes += total.load();
+        if (result.found)
+        {
+            return result;
+        }
+        if (!limitHit.load())
+        {
+            result.exhausted = true;
+            return result;
+        }
+        if (result.nodes >= options.nodeLimit)
+        {
+            break;
+        }
+
+        // Then one walk per thread, each with a fresh seed and its share of the budget
+        uint64_t walkMoves = std::max<uint64_t>(1, std::min(budget, options.nodeLimit - result.nodes) / result.threads);
+        uint64_t firstSeed = options.seed + static_cast<uint64_t>(result.rounds - 1) * result.threads;
+        stop.store(false);
+        total.store(0);
+        for (int walk = 0; walk < result.threads; walk++)
+        {
+            pool.submit([&, walk](int)
+                        {
+                            std::vector<CubeQueen> queens;
+                            uint64_t moves = 0;
+                            bool found = walkCube(n, result.target, firstSeed + walk, walkMoves, stop, queens, moves);
+                            total.fetch_add(moves);
+                            if (found)
+                            {
+                                std::lock_guard<std::mutex> guard(resultLock);
+                                if (!result.found)
+                                {
+                                    result.found = true;
+                                    result.byWalk = true;
+                                    result.queens = queens;
+                                }
+                                stop.store(true);
+                            } });
+        }
+        pool.wait();
+        result.nodes += total.load();
+        if (result.found)
+        {
+            return result;
+        }
+        budget *= 2;
+    }
+    return result;
+}
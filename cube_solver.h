@@ -0,0 +1,99 @@
+#ifndef CUBE_SOLVER_H
+#define CUBE_SOLVER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Largest cube side: the layers of a vertical line fit in a uint32_t
+const int MAX_CUBE_SIZE = 32;
+
+// A queen inside an n x n x n cube: board `layer` (0 = bottom), square (row, col)
+struct CubeQueen
+{
+    int layer;
+    int row;
+    int col;
+};
+
+// Queens in a cube attack along 13 lines: the vertical, the row and column
+// and both diagonals of their layer, and the 8 lines that also climb a layer
+// per step. Seen from above, every one of those lines runs through the
+// vertical lines in the queen's own row, column or diagonals: k squares away
+// (k > 0), the queen covers layers z - k, z and z + k of that vertical line,
+// and all of her own. So the board is kept as one bitset of free layers per
+// vertical line, a placement clears precomputed {z - k, z, z + k} masks along
+// the 8 compass directions in O(n), and a square is free when its bit is set.
+class CubeBoard
+{
+public:
+    explicit CubeBoard(int n = 8);
+
+    int size() const { return n; }
+    const std::vector<CubeQueen> &queens() const { return placed; }
+
+    void clear();
+    bool canPlace(int layer, int row, int col) const { return (free[row * n + col] >> layer) & 1U; }
+    void place(int layer, int row, int col);
+    void remove(int layer, int row, int col); // rebuilds from the other queens
+
+    // Free layers of the vertical line through (row, col)
+    uint32_t freeLayers(int row, int col) const { return free[row * n + col]; }
+
+private:
+    int n;
+    std::vector<uint32_t> free;
+    std::vector<CubeQueen> placed;
+};
+
+// Clears, in `free` (n * n vertical lines), every square a queen on
+// (layer, row, col) attacks or stands on
+void coverCube(int n, uint32_t *free, int layer, int row, int col);
+
+// Most queens that fit in the n x n x n cube without attacking each other,
+// for n up to 11 (OEIS A068940); n * n is reachable only when n is prime to
+// 210, so 11 is the first size after 1 where every vertical line holds one.
+bool knownCubeMaximum(int n, int &queens);
+
+// True when no two of the queens attack each other along any of the 13 lines
+// and all of them are inside the cube (an independent O(q^2) check)
+bool verifyCube(int n, const std::vector<CubeQueen> &queens);
+
+struct CubeSolveOptions
+{
+    int n = 5;
+    int target = -1;             // queens to place, -1 = the known maximum (n * n past the table)
+    int threads = 0;             // 0 = one per hardware thread
+    int prefixDepth = 2;         // decisions expanded into parallel tasks
+    uint64_t seed = 1;           // first seed of the local-search walks
+    uint64_t nodeLimit = UINT64_MAX; // queens placed or moved, across all tasks and rounds
+};
+
+struct CubeSolveResult
+{
+    bool found = false;
+    bool exhausted = false;      // searched everything: no placement of `target` exists
+    bool byWalk = false;         // found by a local-search walk rather than the exact search
+    int target = 0;
+    std::vector<CubeQueen> queens;
+    uint64_t nodes = 0;
+    int rounds = 0;
+    int tasks = 0;               // exact-search tasks per round
+    int threads = 0;
+};
+
+// Places `target` queens with two searches on the work-stealing pool, taken in
+// rounds whose node budget doubles:
+//  - an exact search that branches on the open vertical line with the fewest
+//    free layers, trying each layer and then (when the target still fits)
+//    leaving the line empty; a branch ends when the rows of vertical lines can
+//    no longer hold the queens still missing. Its first prefixDepth decisions
+//    become tasks, and it is the one that can prove a target impossible.
+//  - one min-conflicts walk per thread, each with its own seed: `target`
+//    queens are moved, one conflicted queen at a time, to the square fewest
+//    queens attack. When the parity allows, queens are placed in pairs
+//    mirrored through the centre of the cube, which the dense maxima favour.
+// The first task to succeed stops the rest.
+CubeSolveResult solveCube(const CubeSolveOptions &options);
+
+#endif
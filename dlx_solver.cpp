@@ -0,0 +1,251 @@
+#include "dlx_solver.h"
+
+#include <climits>
+#include <cstddef>
+
+int chooseMinimumRemaining(const DancingLinks &links)
+{
+    int best = 0;
+    int bestSize = INT_MAX;
+    for (int item = links.firstItem(); item != 0; item = links.nextItem(item))
+    {
+        int size = links.itemSize(item);
+        if (size < bestSize)
+        {
+            best = item;
+            bestSize = size;
+            if (size <= 1)
+                break; // forced (or dead): nothing beats it
+        }
+    }
+    return best;
+}
+
+int chooseFirstItem(const DancingLinks &links)
+{
+    return links.firstItem();
+}
+
+DancingLinks::DancingLinks(ItemChooser chooser) : chooser(chooser)
+{
+}
+
+// Items are numbered 1..n for rows, n+1..2n for columns, then the 2n - 1
+// diagonals (row + col) and the 2n - 1 anti-diagonals (row - col + n - 1).
+// Only rows and columns are linked into the ring the choosers walk, in
+// centre-out order (middle line first, then alternating outwards), which is
+// where the constrained lines of a queens board are.
+bool DancingLinks::prepare(const BoardConstraints &constraints)
+{
+    n = constraints.n;
+    if (n < 1)
+    {
+        return false;
+    }
+
+    int items = 1 + 2 * n + 2 * (2 * n - 1);
+    firstOption = items;
+    nodes.assign(firstOption + 4 * n * n, Node{0, 0, 0});
+    next.assign(items, 0);
+    prev.assign(items, 0);
+    sizes.assign(items, 0);
+    chosen.assign(n, 0);
+    for (int item = 0; item < items; item++)
+    {
+        nodes[item] = Node{item, item, item};
+        next[item] = prev[item] = item; // secondary items stay out of the ring
+    }
+
+    int last = 0;
+    for (int k = 0; k < n; k++)
+    {
+        int line = n / 2 + (k % 2 ? -(k + 1) / 2 : k / 2);
+        for (int item : {1 + line, 1 + n + line})
+        {
+            next[last] = item;
+            prev[item] = last;
+            last = item;
+        }
+    }
+    next[last] = 0;
+    prev[0] = last;
+
+    std::vector<char> blocked(static_cast<std::size_t>(n) * n, 0);
+    for (const auto &square : constraints.blocked)
+    {
+        if (square.first < 0 || square.first >= n || square.second < 0 || square.second >= n)
+            return false;
+        blocked[square.first * n + square.second] = 1;
+    }
+
+    // Blocked squares are never linked in, so no search can pick them
+    for (int row = 0; row < n; row++)
+    {
+        for (int col = 0; col < n; col++)
+        {
+            if (blocked[row * n + col])
+                continue;
+            int base = optionNode(row, col);
+            int optionItems[4] = {1 + row, 1 + n + col, 1 + 2 * n + row + col, 1 + 2 * n + (2 * n - 1) + row - col + n - 1};
+            for (int k = 0; k < 4; k++)
+            {
+                int node = base + k;
+                int item = optionItems[k];
+                nodes[node] = Node{nodes[item].up, item, item};
+                nodes[nodes[item].up].down = node;
+                nodes[item].up = node;
+                sizes[item]++;
+            }
+        }
+    }
+
+    // Pre-placed queens are chosen for good: their four items are covered
+    // and never uncovered. An item already covered means two queens clash.
+    std::vector<char> covered(items, 0);
+    for (const auto &queen : constraints.queens)
+    {
+        if (queen.first < 0 || queen.first >= n || queen.second < 0 || queen.second >= n ||
+            blocked[queen.first * n + queen.second])
+        {
+            return false;
+        }
+        int base = optionNode(queen.first, queen.second);
+        for (int k = 0; k < 4; k++)
+        {
+            if (covered[nodes[base + k].item])
+                return false;
+        }
+        for (int k = 0; k < 4; k++)
+        {
+            covered[nodes[base + k].item] = 1;
+            cover(nodes[base + k].item);
+        }
+        placement[queen.first] = queen.second;
+    }
+    return true;
+}
+
+void DancingLinks::hideOption(int node)
+{
+    int base = node - (node - firstOption) % 4;
+    for (int other = base; other < base + 4; other++)
+    {
+        if (other == node)
+            continue;
+        Node &x = nodes[other];
+        nodes[x.up].down = x.down;
+        nodes[x.down].up = x.up;
+        sizes[x.item]--;
+    }
+    STATS_ADD(searchStats, checks, 3);
+}
+
+void DancingLinks::cover(int item)
+{
+    next[prev[item]] = next[item];
+    prev[next[item]] = prev[item];
+    for (int node = nodes[item].down; node != item; node = nodes[node].down)
+    {
+        hideOption(node);
+    }
+}
+
+// Exact reverse of cover(): options come back bottom to top, and each
+// option's nodes in the opposite order to the one they were hidden in
+void DancingLinks::uncover(int item)
+{
+    for (int node = nodes[item].up; node != item; node = nodes[node].up)
+    {
+        int base = node - (node - firstOption) % 4;
+        for (int other = base + 3; other >= base; other--)
+        {
+            if (other == node)
+                continue;
+            Node &x = nodes[other];
+            nodes[x.up].down = other;
+            nodes[x.down].up = other;
+            sizes[x.item]++;
+        }
+    }
+    next[prev[item]] = item;
+    prev[next[item]] = item;
+}
+
+bool DancingLinks::search(int depth)
+{
+    if (next[0] == 0)
+    {
+        // Every row and column is covered: read the squares back
+        for (int d = 0; d < depth; d++)
+        {
+            int square = (chosen[d] - firstOption) / 4;
+            placement[square / n] = square % n;
+        }
+        STATS_ADD(searchStats, solutions, 1);
+        return ++found >= limit;
+    }
+
+    int item = chooser(*this);
+    if (item == 0 || sizes[item] == 0)
+    {
+        STATS_ADD(searchStats, prunes, 1);
+        return false;
+    }
+
+    cover(item);
+    for (int node = nodes[item].down; node != item; node = nodes[node].down)
+    {
+        visited++;
+        STATS_NODE(searchStats, depth);
+        chosen[depth] = node;
+        int base = node - (node - firstOption) % 4;
+        for (int other = base; other < base + 4; other++)
+        {
+            if (other != node)
+                cover(nodes[other].item);
+        }
+        bool done = search(depth + 1);
+        for (int other = base + 3; other >= base; other--)
+        {
+            if (other != node)
+                uncover(nodes[other].item);
+        }
+        if (done)
+        {
+            uncover(item);
+            return true;
+        }
+    }
+    uncover(item);
+    return false;
+}
+
+uint64_t DancingLinks::run(const BoardConstraints &constraints, int *out, uint64_t maxFound, uint64_t *nodesOut)
+{
+    placement = out;
+    found = 0;
+    limit = maxFound;
+    visited = 0;
+    searchStats.clear();
+    StatsTimer timer(&searchStats);
+    if (maxFound > 0 && prepare(constraints))
+    {
+        search(0);
+    }
+    if (nodesOut)
+    {
+        *nodesOut += visited;
+    }
+    return found;
+}
+
+bool DancingLinks::solve(const BoardConstraints &constraints, int *placementOut, uint64_t *nodesOut)
+{
+    return run(constraints, placementOut, 1, nodesOut) > 0;
+}
+
+uint64_t DancingLinks::count(const BoardConstraints &constraints, uint64_t maxFound, uint64_t *nodesOut)
+{
+    scratch.assign(constraints.n > 0 ? constraints.n : 0, 0);
+    return run(constraints, scratch.data(), maxFound, nodesOut);
+}
@@ -0,0 +1,89 @@
+#ifndef DLX_SOLVER_H
+#define DLX_SOLVER_H
+
+#include "board_constraints.h"
+#include "solver_stats.h"
+
+#include <cstdint>
+#include <vector>
+
+class DancingLinks;
+
+// Picks the primary item (a row or column of the board) to branch on next,
+// walking the active items with firstItem()/nextItem(). Returning an item with
+// no options left makes the search backtrack at once.
+typedef int (*ItemChooser)(const DancingLinks &links);
+
+// Item with the fewest remaining options; ties go to the item nearest the
+// centre of the board. The usual choice, and the default.
+int chooseMinimumRemaining(const DancingLinks &links);
+
+// First active item in centre-out order, whatever its size
+int chooseFirstItem(const DancingLinks &links);
+
+// Algorithm X with dancing links on N-queens as an exact cover problem. Each
+// square is an option covering four items: its row and column are primary
+// (covered exactly once) and its two diagonals are secondary (at most once).
+// Every node lives in one contiguous array and links to the others by index;
+// a square's four nodes sit next to each other, so an option is walked by
+// index arithmetic instead of left/right links. Blocked squares are hidden
+// and pre-placed queens are chosen before the search starts. Boards of any
+// size work; the matrix takes about 4n^2 nodes.
+class DancingLinks
+{
+public:
+    explicit DancingLinks(ItemChooser chooser = chooseMinimumRemaining);
+
+    void setChooser(ItemChooser next) { chooser = next; }
+
+    // First completion of `constraints` into placement[0..n); false when there
+    // is none. nodes (optional) is increased by the number of queens placed,
+    // pre-placed queens excluded.
+    bool solve(const BoardConstraints &constraints, int *placement, uint64_t *nodes = nullptr);
+
+    // Completions of `constraints`, stopping once `limit` are found
+    uint64_t count(const BoardConstraints &constraints, uint64_t limit = UINT64_MAX, uint64_t *nodes = nullptr);
+
+    // Active primary items for choosers: 0 ends the list
+    int firstItem() const { return next[0]; }
+    int nextItem(int item) const { return next[item]; }
+    int itemSize(int item) const { return sizes[item]; }
+
+    // Counters of the last solve() or count(); a check is one option node
+    // unlinked, depth is the number of queens the search itself has placed
+    const SolverStats &stats() const { return searchStats; }
+
+private:
+    struct Node
+    {
+        int up;
+        int down;
+        int item;
+    };
+
+    uint64_t run(const BoardConstraints &constraints, int *out, uint64_t maxFound, uint64_t *nodesOut);
+    bool prepare(const BoardConstraints &constraints);
+    void cover(int item);
+    void uncover(int item);
+    void hideOption(int node);
+    bool search(int depth);
+
+    int optionNode(int row, int col) const { return firstOption + 4 * (row * n + col); }
+
+    ItemChooser chooser;
+    int n = 0;
+    int firstOption = 0;        // nodes before this are item headers
+    std::vector<Node> nodes;    // headers, then four nodes per square
+    std::vector<int> next;      // ring of active primary items, 0 is the root
+    std::vector<int> prev;
+    std::vector<int> sizes;     // options left in each item
+    std::vector<int> chosen;    // option node chosen at each depth
+    int *placement = nullptr;   // where search() writes a completion
+    std::vector<int> scratch;   // count() completions land here
+    uint64_t found = 0;
+    uint64_t limit = 0;
+    uint64_t visited = 0;
+    SolverStats searchStats;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "empty_row_search.h"
+
+void EmptyRowSearch::reset(int size)
+{
+    n = size;
+    for (int row = 0; row < n; row++)
+    {
+        open[row] = boardMask(n);
+        placed[row] = -1;
+    }
+    filled = 0;
+    cols = 0;
+    diagonals = 0;
+    antiDiagonals = 0;
+    rowCount = 0;
+    nodes = 0;
+    nodeLimit = UINT64_MAX;
+    stats = nullptr;
+    cancel = nullptr;
+}
+
+bool EmptyRowSearch::fix(int row, int col)
+{
+    if (row < 0 || row >= n || col < 0 || col >= n)
+    {
+        return false;
+    }
+    uint64_t bit = 1ULL << col;
+    WideMask diagonal = static_cast<WideMask>(1) << (row + col);
+    WideMask antiDiagonal = static_cast<WideMask>(1) << (col - row + n - 1);
+    if ((filled >> row) & 1ULL || !(open[row] & bit) || cols & bit || diagonals & diagonal ||
+        antiDiagonals & antiDiagonal)
+    {
+        return false;
+    }
+    placed[row] = col;
+    filled |= 1ULL << row;
+    cols |= bit;
+    diagonals |= diagonal;
+    antiDiagonals |= antiDiagonal;
+    return true;
+}
+
+bool EmptyRowSearch::block(int row, int col)
+{
+    if (row < 0 || row >= n || col < 0 || col >= n)
+    {
+        return false;
+    }
+    open[row] &= ~(1ULL << col);
+    return true;
+}
+
+void EmptyRowSearch::listEmptyRows()
+{
+    rowCount = 0;
+    for (int row = 0; row < n; row++)
+    {
+        if (!((filled >> row) & 1ULL))
+        {
+            rows[rowCount++] = row;
+        }
+    }
+}
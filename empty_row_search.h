@@ -0,0 +1,95 @@
+#ifndef EMPTY_ROW_SEARCH_H
+#define EMPTY_ROW_SEARCH_H
+
+#include "solver.h"
+#include "solver_stats.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Diagonals need 2N - 1 bits, so they are 128-bit masks indexed so that a
+// row's attacked columns are a plain shift: bit (row + col) and bit
+// (col - row + n - 1)
+typedef unsigned __int128 WideMask;
+
+// Depth-first completion of a partial board: one queen in each row the board
+// leaves empty, rows taken in order. Queens already down are fixed first, and
+// squares can be blocked; run() then calls visit(search) on every completion,
+// with placed[row] the column of each row, until visit returns true.
+struct EmptyRowSearch
+{
+    int n;
+    uint64_t open[MAX_BOARD_SIZE]; // squares of each row a queen may take
+    int placed[MAX_BOARD_SIZE];    // column of each row, fixed or searched
+    uint64_t filled;               // rows with a fixed queen
+    uint64_t cols;                 // masks of the fixed queens
+    WideMask diagonals;
+    WideMask antiDiagonals;
+    int rows[MAX_BOARD_SIZE];      // the empty rows, set by listEmptyRows()
+    int rowCount;
+
+    uint64_t nodes;                // queens placed by the search
+    uint64_t nodeLimit;            // stop placing after this many
+    SolverStats *stats;            // null when not instrumented
+    const std::atomic<bool> *cancel; // when set, unwinds without a result
+
+    // An empty size x size board (n must be 1..MAX_BOARD_SIZE)
+    void reset(int size);
+
+    // False when the square is off the board, blocked, or shares a row,
+    // column or diagonal with a fixed queen: nothing completes the board then
+    bool fix(int row, int col);
+    // False when the square is off the board
+    bool block(int row, int col);
+    void listEmptyRows();
+
+    // True once visit has returned true; false when the search ran out, hit
+    // nodeLimit or was cancelled
+    template <typename Visit>
+    bool run(Visit &visit) { return search(0, cols, diagonals, antiDiagonals, visit); }
+
+private:
+    template <typename Visit>
+    bool search(int depth, uint64_t taken, WideMask down, WideMask up, Visit &visit);
+};
+
+template <typename Visit>
+bool EmptyRowSearch::search(int depth, uint64_t taken, WideMask down, WideMask up, Visit &visit)
+{
+    if (depth == rowCount)
+    {
+        if (stats)
+            STATS_ADD(*stats, solutions, 1);
+        return visit(*this);
+    }
+    if (cancel && cancel->load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    int row = rows[depth];
+    uint64_t free = open[row] & ~taken & ~static_cast<uint64_t>(down >> row) &
+                    ~static_cast<uint64_t>(up >> (n - 1 - row));
+    if (stats)
+    {
+        STATS_ADD(*stats, checks, 1);
+        STATS_ADD(*stats, prunes, free ? 0 : 1);
+    }
+    while (free && nodes < nodeLimit)
+    {
+        uint64_t bit = free & (0 - free);
+        free ^= bit;
+        nodes++;
+        if (stats)
+            STATS_NODE(*stats, row);
+        placed[row] = lowestBit(bit);
+        if (search(depth + 1, taken | bit, down | (static_cast<WideMask>(bit) << row),
+                   up | (static_cast<WideMask>(bit) << (n - 1 - row)), visit))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#include "fixed_solver.h"
+
+#include <utility>
+
+// Dispatch tables indexed by n - FIXED_MIN_SIZE, built from an index sequence
+// so every Solver<N> in the range is instantiated here and nowhere else
+template <int... Offsets>
+static const FixedCountFunction *countTable(std::integer_sequence<int, Offsets...>)
+{
+    static const FixedCountFunction table[] = {&Solver<FIXED_MIN_SIZE + Offsets>::count...};
+    return table;
+}
+
+template <int... Offsets>
+static const FixedFirstFunction *firstTable(std::integer_sequence<int, Offsets...>)
+{
+    static const FixedFirstFunction table[] = {&Solver<FIXED_MIN_SIZE + Offsets>::first...};
+    return table;
+}
+
+typedef std::make_integer_sequence<int, FIXED_MAX_SIZE - FIXED_MIN_SIZE + 1> FixedSizes;
+
+FixedCountFunction fixedCounter(int n)
+{
+    if (n < FIXED_MIN_SIZE || n > FIXED_MAX_SIZE)
+    {
+        return nullptr;
+    }
+    return countTable(FixedSizes())[n - FIXED_MIN_SIZE];
+}
+
+FixedFirstFunction fixedFirstSolver(int n)
+{
+    if (n < FIXED_MIN_SIZE || n > FIXED_MAX_SIZE)
+    {
+        return nullptr;
+    }
+    return firstTable(FixedSizes())[n - FIXED_MIN_SIZE];
+}
@@ -0,0 +1,98 @@
+#ifndef FIXED_SOLVER_H
+#define FIXED_SOLVER_H
+
+#include <cstdint>
+#include <type_traits>
+
+// Board sizes with a compiled-in solver
+const int FIXED_MIN_SIZE = 4;
+const int FIXED_MAX_SIZE = 32;
+
+// Smallest unsigned type with at least N bits
+template <int N>
+struct FixedMask
+{
+    typedef typename std::conditional<(N <= 8), uint8_t,
+                                      typename std::conditional<(N <= 16), uint16_t, uint32_t>::type>::type type;
+};
+
+// The bitboard search with the board size fixed at compile time. Each row is
+// its own instantiation, so the row-by-row recursion is unrolled into N nested
+// loops, the mask width matches the board, and the last row reduces to a
+// popcount. Node counts match countSolutions() and solveQueens().
+template <int N>
+class Solver
+{
+public:
+    typedef typename FixedMask<N>::type Mask;
+    static constexpr unsigned FULL = N >= 32 ? ~0u : (1u << N) - 1;
+
+    static uint64_t count(uint64_t &nodes)
+    {
+        return countRow<0>(0, 0, 0, nodes);
+    }
+
+    static bool first(int *placement, uint64_t &nodes)
+    {
+        return firstRow<0>(0, 0, 0, placement, nodes);
+    }
+
+private:
+    template <int Row>
+    static uint64_t countRow(Mask cols, Mask left, Mask right, uint64_t &nodes)
+    {
+        unsigned free = FULL & ~static_cast<unsigned>(cols | left | right);
+        if (Row == N - 1)
+        {
+            // Every free square of the last row completes a solution
+            unsigned last = static_cast<unsigned>(__builtin_popcount(free));
+            nodes += last;
+            return last;
+        }
+
+        uint64_t count = 0;
+        while (free)
+        {
+            unsigned bit = free & (0u - free);
+            free ^= bit;
+            nodes++;
+            count += countRow<(Row + 1 < N ? Row + 1 : Row)>(static_cast<Mask>(cols | bit),
+                                                            static_cast<Mask>((left | bit) << 1),
+                                                            static_cast<Mask>((right | bit) >> 1), nodes);
+        }
+        return count;
+    }
+
+    template <int Row>
+    static bool firstRow(Mask cols, Mask left, Mask right, int *placement, uint64_t &nodes)
+    {
+        unsigned free = FULL & ~static_cast<unsigned>(cols | left | right);
+        while (free)
+        {
+            unsigned bit = free & (0u - free);
+            free ^= bit;
+            placement[Row] = __builtin_ctz(bit);
+            nodes++;
+            if (Row == N - 1)
+            {
+                return true;
+            }
+            if (firstRow<(Row + 1 < N ? Row + 1 : Row)>(static_cast<Mask>(cols | bit),
+                                                        static_cast<Mask>((left | bit) << 1),
+                                                        static_cast<Mask>((right | bit) >> 1), placement, nodes))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+typedef uint64_t (*FixedCountFunction)(uint64_t &nodes);
+typedef bool (*FixedFirstFunction)(int *placement, uint64_t &nodes);
+
+// Compiled solver for a runtime size, or nullptr outside FIXED_MIN_SIZE..FIXED_MAX_SIZE
+FixedCountFunction fixedCounter(int n);
+FixedFirstFunction fixedFirstSolver(int n);
+
+#endif
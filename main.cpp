@@ -8,10 +8,28 @@
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
+#include "solver.h"
+#include "parallel_counter.h"
+#include "solve_strategy.h"
+#include "solution_table.h"
+#include "completion_oracle.h"
+#include "viability_heatmap.h"
+#include "stepwise_solver.h"
+#include "solution_index.h"
+#include "solution_sampler.h"
+#include "puzzle_generator.h"
+#include "propagation_solver.h"
+#include "solver_stats.h"
+#include "search_trace.h"
+#include "board_variant.h"
+#include "cube_solver.h"
+#include "threat_map.h"
 
 // Store the texture IDs separately
 std::vector<GLuint> queenTextures;
@@ -42,19 +60,79 @@ bool isRotating = false; // Flag to check if rotation is happening
 
 // Queen positions
 std::vector<std::pair<int, int>> queens; // Positions of placed queens
+Bitboard board(BOARD_SIZE);              // Rows, columns and diagonals taken by the queens
+
+// Variant in play: the pieces, and how many of the 8 rows are in use (the
+// rest are shaded and take no pieces, which makes a rows x 8 board). The
+// variant board feeds the completion counts and hints.
+BoardVariant gameVariant;
+AttackTable variantTable(gameVariant);
+VariantBoard variantBoard(variantTable);
+uint64_t variantSolutions = 92; // solutions of the whole variant board
+void selectVariant(VariantKind kind, int rows);
+void showPlacement(const int *placement, int depth);
+bool needsClassicBoard();
+
+// Attack count of every square under the variant's moves, updated as each
+// queen goes down or comes off (never rebuilt from `queens`); the unused rows
+// start blocked, so isValidMove is one array read on any variant. 'A' shows
+// it as a translucent overlay kept in a texture with a texel per square.
+ThreatMap threatMap(gameVariant, BOARD_SIZE);
+bool showThreats = false;
+GLuint threatTexture = 0;
+void drawThreats();
+void threatTexel(int row, int col, uint8_t *texel);
+
+// Live dead-end detection
+CompletionOracle completionOracle;
+uint64_t remainingCompletions = 0; // solutions that still extend the board
+bool isDeadEnd = false;            // queens left to place but no solution contains the current ones
+void updateCompletions(const Bitboard &position);
+
+// Cube mode: BOARD_SIZE boards stacked into a cube, where queens also attack
+// straight up and down and along the 10 lines that climb a layer per step
+// (cube_solver.h). Clicks go to the active layer; the others are see-through.
+const float CUBE_LAYER_GAP = 0.25f; // height between stacked boards
+bool cubeMode = false;
+int activeLayer = 0;
+CubeBoard cubeBoard(BOARD_SIZE);
+int cubeTarget = 48;                // the most queens that fit, from knownCubeMaximum
+bool cubeWon = false;
+bool cubeComputerSolved = false;
+void toggleCubeMode();
+void cubeKeyboard(unsigned char key);
+void placeCubeQueen(int layer, int row, int col);
+void solveGameCube();
+void drawCube();
+float layerHeight(int layer);
+
+// Viability heatmap: solutions left through each free square, counted in the background
+ViabilityHeatmap viabilityHeatmap;
+bool showHeatmap = false;
+bool heatmapRefreshing = false; // a redraw timer is running while counts arrive
+void drawHeatmap();
+void refreshHeatmap(int value);
+void startHeatmapRefresh();
 
 // Function prototypes
 void display();
 void reshape(int w, int h);
-void resetBoard();
+// Starting position for resetBoard()
+enum StartLayout
+{
+    START_EMPTY,
+    START_SEEDED, // half the queens of a random solution
+    START_PUZZLE  // clues with exactly one completion
+};
+void resetBoard(StartLayout start = START_EMPTY);
 void keyboard(unsigned char key, int x, int y);
 void mouse(int button, int state, int x, int y);
 void motion(int x, int y);
-void drawChessboard();
+void drawChessboard(float height = tableTopHeight + 0.12f, float opacity = 1.0f);
 void drawQueen(float x, float y, float z);
 bool isValidMove(int row, int col);
 void placeQueen(int row, int col);
-void animateQueen(int value);
+void animateQueen(int generation);
 void renderBitmapString(float x, float y, float z, void *font, const char *string);
 void drawGuide();
 void drawScore();
@@ -94,21 +172,77 @@ int highScore;
 const std::string highScoreFile = "highscore.txt";
 
 // SOLVE!
-bool solveQueens(int col);
 void autoSolve();
-void highlightSquare(int row, int col);
+void finishSolve();
+void countAllSolutions();
+void loadSolution(const std::vector<int> &placement);
+void showNextSolution();
+void showHintMove();
+void highlightSquare(int row, int col, float red = 1.0f, float green = 1.0f, float blue = 0.0f,
+                     float height = tableTopHeight + 0.125f);
 void clearHighlight();
+void solveTick(int generation);
+void changeSolveSpeed(int direction);
 
 // more global variables
 bool isSolving = false;
 int currentSolveCol = 0;
-int solveDelay = 500; // milliseconds
+int solveDelay = 50; // milliseconds between solver ticks (at most one frame at high speeds)
+
+// Stepwise auto-solve: the search advances a budget of steps on every tick
+StepwiseSolver stepSolver(BOARD_SIZE);
+const int SOLVE_SPEEDS[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000,
+                            20000, 50000, 100000, 200000, 500000, 1000000, 2000000, 5000000};
+const int SOLVE_SPEED_COUNT = sizeof(SOLVE_SPEEDS) / sizeof(SOLVE_SPEEDS[0]);
+int solveSpeed = 4;             // index into SOLVE_SPEEDS (steps per second)
+double solveBudget = 0.0;       // steps owed but not yet taken
+int lastSolveTick = 0;          // GLUT time of the previous tick
+int solveGeneration = 0;        // ticks from an abandoned solve ignore themselves
 bool isComputerSolved = false;
 bool winSoundPlayed = false;
 
+// Trace replay: a recorded search (place/remove events) played back at
+// SOLVE_SPEEDS events per second on a flat n x n board, so any size fits.
+// Events between two frames are skipped, not drawn; 8x8 traces are mirrored
+// onto the 3D board as well.
+SearchTrace replayTrace;
+TraceCursor replayCursor(replayTrace);
+std::string replayPath = "queens8.nqt"; // first program argument; recorded on first use if missing
+bool isReplaying = false;
+bool replayPaused = false;
+double replayBudget = 0.0;  // events owed but not yet applied
+int lastReplayTick = 0;
+int replayGeneration = 0;
+const int REPLAY_FRAME_MS = 16; // about 60 frames per second
+void toggleReplay();
+void replayTick(int generation);
+void seekReplay(int64_t events);
+void seekReplaySolution(int direction);
+void drawReplay();
+
+// Solution browser (unranked from the index) and hints (8x8: straight from
+// the compile-time table)
+int64_t shownSolution = -1; // rank of the solution last shown with 'N'
+SolutionIndex solutionIndex;  // built on first use; lexicographic, like the 8x8 table's order
+SolutionSampler solutionSampler(solutionIndex, static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+void ensureSolutionIndex();
+bool showHint = false;
+int hintTimer = 0;
+std::pair<int, int> hintSquare;
+std::string hintMessage; // shown instead of a square when no hint exists
+
+// A full solution extending the player's queens, found by forward checking
+// each time a queen goes down or is undone (other sizes take their hints from
+// it). Empty when none is known, e.g. after a dead end until it is undone.
+PropagationSolver completionSolver;
+std::vector<int> playerCompletion;
+const uint64_t COMPLETION_NODE_LIMIT = 1ULL << 22; // keeps a pathological board from stalling a click
+void updatePlayerCompletion(const std::vector<std::pair<int, int>> &layout);
+
 // Animation properties
 const int ANIMATION_DURATION = 500; // milliseconds
-bool isAnimating = false;
+bool isAnimating = false; // only the drawing: the queen is already on the board
+int animationGeneration = 0; // bumped by resetBoard so a running timer stops
 float animationStartTime;
 std::pair<int, int> animationStartPos;
 std::pair<int, int> animationEndPos;
@@ -126,6 +260,10 @@ int main(int argc, char **argv)
     initOpenAL();
 
     glutInit(&argc, argv);
+    if (argc > 1)
+    {
+        replayPath = argv[1]; // a trace written by `nqueens -m trace -o FILE`
+    }
 
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH | GLUT_MULTISAMPLE); // Enable anti-aliasing GLUT_MULTISAMPLE
     glEnable(GL_MULTISAMPLE);
@@ -197,11 +335,28 @@ void display()
     // Draw other objects
     drawGroundPlane();
     drawTable();
-    drawChessboard();
+    if (cubeMode)
+    {
+        drawCube();
+    }
+    else
+    {
+        drawChessboard();
+        for (int row = gameVariant.rows; row < BOARD_SIZE; row++)
+        {
+            for (int col = 0; col < BOARD_SIZE; col++)
+                highlightSquare(row, col, 0.05f, 0.05f, 0.05f); // rows outside the variant
+        }
+        if (showThreats)
+        {
+            drawThreats();
+        }
+    }
     drawGuide();
 
-    // Draw queens
-    for (size_t i = 0; i < queens.size(); ++i)
+    // Draw queens; the one still flying in is drawn by the animation below
+    size_t settled = isAnimating && !queens.empty() ? queens.size() - 1 : queens.size();
+    for (size_t i = 0; i < settled; ++i)
     {
         float x = (queens[i].second - BOARD_SIZE / 2 + 0.5f) * SQUARE_SIZE;
         float z = (queens[i].first - BOARD_SIZE / 2 + 0.5f) * SQUARE_SIZE;
@@ -227,23 +382,35 @@ void display()
         drawQueen(x, y, z);
     }
 
-    drawScore();
+    if (!cubeMode)
+    {
+        drawScore();
+    }
+    if (isReplaying)
+    {
+        drawReplay();
+    }
 
     if (isSolving)
     {
-        // Highlight the current square being considered
-        if (!queens.empty())
+        // Highlight the square the solver last touched: yellow for a
+        // placement, red for a queen it just took back
+        if (stepSolver.lastRow() >= 0)
         {
-            int row = queens.back().first;
-            int col = queens.back().second;
-            highlightSquare(row, col);
+            if (stepSolver.lastEvent() == SOLVE_REMOVED)
+                highlightSquare(stepSolver.lastRow(), stepSolver.lastCol(), 1.0f, 0.2f, 0.2f);
+            else
+                highlightSquare(stepSolver.lastRow(), stepSolver.lastCol());
         }
 
         // Display "Solving..." message
+        std::ostringstream solving;
+        solving << "Solving... " << stepSolver.steps() << " steps at " << SOLVE_SPEEDS[solveSpeed]
+                << " steps/s (+/- to change)";
         glDisable(GL_LIGHTING);
         glDisable(GL_TEXTURE_2D);
         glColor3f(0.0f, 0.5f, 1.0f);
-        renderBitmapString(-1.0f, tableTopHeight + 2 * SQUARE_SIZE, 0.0f, GLUT_BITMAP_HELVETICA_18, "Solving...");
+        renderBitmapString(-1.0f, tableTopHeight + 2 * SQUARE_SIZE, 0.0f, GLUT_BITMAP_HELVETICA_18, solving.str().c_str());
         glEnable(GL_LIGHTING);
         glEnable(GL_TEXTURE_2D);
     }
@@ -259,6 +426,41 @@ void display()
         glEnable(GL_TEXTURE_2D);
     }
 
+    if (isDeadEnd && !gameWon)
+    {
+        glDisable(GL_LIGHTING);
+        glDisable(GL_TEXTURE_2D);
+        glColor3f(1.0f, 0.3f, 0.0f);
+        renderBitmapString(-1.6f, tableTopHeight + thickness + 0.6f, 0.0f, GLUT_BITMAP_HELVETICA_18, "Dead end: no solution contains these queens. Undo a move.");
+        glEnable(GL_LIGHTING);
+        glEnable(GL_TEXTURE_2D);
+    }
+
+    if (showHint)
+    {
+        int currentTime = glutGet(GLUT_ELAPSED_TIME);
+        if (currentTime - hintTimer < 3000)
+        {
+            if (hintMessage.empty())
+            {
+                highlightSquare(hintSquare.first, hintSquare.second);
+            }
+            else
+            {
+                glDisable(GL_LIGHTING);
+                glDisable(GL_TEXTURE_2D);
+                glColor3f(1.0f, 0.6f, 0.0f);
+                renderBitmapString(-1.6f, tableTopHeight + thickness + 0.7f, 0.0f, GLUT_BITMAP_HELVETICA_18, hintMessage.c_str());
+                glEnable(GL_LIGHTING);
+                glEnable(GL_TEXTURE_2D);
+            }
+        }
+        else
+        {
+            showHint = false;
+        }
+    }
+
     if (showTryAgainWarning)
     {
         int currentTime = glutGet(GLUT_ELAPSED_TIME);
@@ -450,9 +652,38 @@ void reshape(int w, int h)
     glMatrixMode(GL_MODELVIEW);
 }
 
-void resetBoard()
+// Clears the board and puts down the starting queens: none, half the queens
+// of a uniformly random solution (which can always be completed), or the
+// clues of a generated puzzle (which can be completed in exactly one way).
+void resetBoard(StartLayout start)
 {
     queens.clear();
+    board.clear();
+    variantBoard.clear();
+    threatMap.reset(gameVariant, BOARD_SIZE);
+    std::vector<std::pair<int, int>> layout;
+    if (start == START_SEEDED)
+    {
+        ensureSolutionIndex();
+        solutionSampler.samplePartial(BOARD_SIZE / 2, layout);
+    }
+    else if (start == START_PUZZLE)
+    {
+        ensureSolutionIndex();
+        Puzzle puzzle = generatePuzzle(solutionIndex, static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+        layout = puzzle.clues;
+        std::cout << "Puzzle (" << gradeName(puzzle.grade) << "): " << puzzle.clues.size()
+                  << " queens given, exactly one way to place the rest" << std::endl;
+    }
+    for (const auto &queen : layout)
+    {
+        queens.push_back(queen);
+        board.place(queen.first, queen.second);
+        variantBoard.place(queen.first, queen.second);
+        threatMap.place(queen.first, queen.second);
+    }
+    updateCompletions(board);
+    updatePlayerCompletion(queens);
     numberOfTries = 0;
     undoStack.clear();
     showTryAgainWarning = false;
@@ -460,29 +691,68 @@ void resetBoard()
     gameWon = false;         // Ensure gameWon is reset
     isComputerSolved = false;
     isSolving = false;       // Ensure auto-solve state is reset
+    isReplaying = false;
+    showHint = false;
     isRotating = false;
     isAnimating = false;     // Stop any ongoing animation
+    animationGeneration++;
     loadHighScore();         // Load high score when the board is reset
     glutPostRedisplay();     // Redraw the scene
 }
 
 void keyboard(unsigned char key, int x, int y)
 {
+    if (cubeMode)
+    {
+        cubeKeyboard(key);
+        return;
+    }
     switch (key)
     {
     case 'r':
     case 'R':
         resetBoard();
         break;
+    case 'g':
+    case 'G':
+        if (!needsClassicBoard())
+            resetBoard(START_SEEDED);
+        break;
+    case 'p':
+    case 'P':
+        if (!needsClassicBoard())
+            resetBoard(START_PUZZLE);
+        break;
+    case 'm':
+    case 'M':
+        selectVariant(static_cast<VariantKind>((gameVariant.kind + 1) % VARIANT_KIND_COUNT), gameVariant.rows);
+        break;
+    case 'b':
+    case 'B':
+        selectVariant(gameVariant.kind, gameVariant.rows > 4 ? gameVariant.rows - 1 : BOARD_SIZE);
+        break;
+    case 'x':
+    case 'X':
+        toggleCubeMode();
+        break;
+    case 'a':
+    case 'A':
+        showThreats = !showThreats;
+        break;
     case 27: // ESC key
         exit(0);
         break;
     case 'u':
     case 'U':
-        if (!undoStack.empty())
+        if (!undoStack.empty() && !isAnimating)
         {
+            board.remove(queens.back().first, queens.back().second);
+            variantBoard.remove(queens.back().first, queens.back().second);
+            threatMap.remove(queens.back().first, queens.back().second);
             queens.pop_back();
             undoStack.pop_back();
+            updateCompletions(board);
+            updatePlayerCompletion(queens);
             gameWon = false;
             glutPostRedisplay();
         }
@@ -491,8 +761,69 @@ void keyboard(unsigned char key, int x, int y)
     case 'S':
         if (!isSolving)
         {
-            autoSolve();
+            if (!needsClassicBoard())
+                autoSolve();
         }
+        else
+        {
+            finishSolve();
+        }
+        break;
+    case '+':
+    case '=':
+        changeSolveSpeed(1);
+        break;
+    case '-':
+    case '_':
+        changeSolveSpeed(-1);
+        break;
+    case 'c':
+    case 'C':
+        countAllSolutions();
+        break;
+    case 'n':
+    case 'N':
+        if (!needsClassicBoard())
+            showNextSolution();
+        break;
+    case 'h':
+    case 'H':
+        showHintMove();
+        break;
+    case 'v':
+    case 'V':
+        if (needsClassicBoard())
+            break;
+        showHeatmap = !showHeatmap;
+        startHeatmapRefresh();
+        break;
+    case 't':
+    case 'T':
+        if (!needsClassicBoard())
+            toggleReplay();
+        break;
+    case ' ':
+        replayPaused = !replayPaused;
+        break;
+    case '[':
+        seekReplay(-static_cast<int64_t>(replayTrace.size() / 20 + 1));
+        break;
+    case ']':
+        seekReplay(static_cast<int64_t>(replayTrace.size() / 20 + 1));
+        break;
+    case ',':
+        replayPaused = true;
+        seekReplay(-1);
+        break;
+    case '.':
+        replayPaused = true;
+        seekReplay(1);
+        break;
+    case '<':
+        seekReplaySolution(-1);
+        break;
+    case '>':
+        seekReplaySolution(1);
         break;
     }
     glutPostRedisplay();
@@ -514,7 +845,7 @@ void mouse(int button, int state, int x, int y)
             isRotating = false;
         }
     }
-    if (button == GLUT_LEFT_BUTTON && state == GLUT_UP && !isRotating)
+    if (button == GLUT_LEFT_BUTTON && state == GLUT_UP && !isRotating && !isAnimating)
     {
         GLint viewport[4];
         GLdouble modelview[16], projection[16];
@@ -530,16 +861,37 @@ void mouse(int button, int state, int x, int y)
         glReadPixels(x, int(winY), 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &winZ);
 
         gluUnProject(winX, winY, winZ, modelview, projection, viewport, &posX, &posY, &posZ);
+        if (cubeMode)
+        {
+            // The depth buffer holds whatever the click hit first, so follow
+            // the click ray down to the active layer instead
+            GLdouble nearX, nearY, nearZ, farX, farY, farZ;
+            gluUnProject(winX, winY, 0.0, modelview, projection, viewport, &nearX, &nearY, &nearZ);
+            gluUnProject(winX, winY, 1.0, modelview, projection, viewport, &farX, &farY, &farZ);
+            double t = farY != nearY ? (layerHeight(activeLayer) - nearY) / (farY - nearY) : -1.0;
+            if (t < 0.0)
+            {
+                glutPostRedisplay();
+                return;
+            }
+            posX = nearX + t * (farX - nearX);
+            posZ = nearZ + t * (farZ - nearZ);
+        }
 
         int row = int((posZ / SQUARE_SIZE) + BOARD_SIZE / 2);
         int col = int((posX / SQUARE_SIZE) + BOARD_SIZE / 2);
 
         if (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE)
         {
-            if (isValidMove(row, col))
+            bool valid = cubeMode ? cubeBoard.canPlace(activeLayer, row, col) : isValidMove(row, col);
+            if (valid && cubeMode)
+            {
+                placeCubeQueen(activeLayer, row, col);
+            }
+            else if (valid)
             {
                 placeQueen(row, col);
-                if (queens.size() == 8)
+                if (static_cast<int>(queens.size()) == gameVariant.rows)
                 {
                     std::cout << "Congratulations! You solved the 8-queen puzzle!" << std::endl;
                 }
@@ -578,13 +930,24 @@ void motion(int x, int y)
     }
 }
 
-void drawChessboard()
+void drawChessboard(float height, float opacity)
 {
     glEnable(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, chessboardTexture);
 
+    // A see-through board blends and keeps out of the depth buffer, so the
+    // queens and boards under it still show
+    if (opacity < 1.0f)
+    {
+        GLfloat boardColor[] = {1.0f, 1.0f, 1.0f, opacity};
+        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, boardColor);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+    }
+
     glPushMatrix();
-    glTranslatef(-BOARD_SIZE * SQUARE_SIZE / 2, tableTopHeight + 0.12f, -BOARD_SIZE * SQUARE_SIZE / 2); // Adjust height
+    glTranslatef(-BOARD_SIZE * SQUARE_SIZE / 2, height, -BOARD_SIZE * SQUARE_SIZE / 2); // Adjust height
     glBegin(GL_QUADS);
 
     glBegin(GL_QUADS);
@@ -601,7 +964,152 @@ void drawChessboard()
 
     glPopMatrix();
 
+    if (opacity < 1.0f)
+    {
+        GLfloat white[] = {1.0f, 1.0f, 1.0f, 1.0f};
+        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, white);
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+    glDisable(GL_TEXTURE_2D);
+
+    if (showHeatmap && !isSolving && gameVariant.isClassic() && !cubeMode)
+    {
+        drawHeatmap();
+    }
+}
+
+// Red for a square the queens attack, deeper the more of them do; clear for a
+// free square and for the rows the variant leaves out (already shaded)
+void threatTexel(int row, int col, uint8_t *texel)
+{
+    int attacks = threatMap.isBlocked(row) ? 0 : threatMap.attacks(row, col);
+    texel[0] = 255;
+    texel[1] = 40;
+    texel[2] = 40;
+    texel[3] = static_cast<uint8_t>(attacks == 0 ? 0 : std::min(60 + 30 * attacks, 200));
+}
+
+// The threat map as one quad just above the board. Only the texels of the
+// squares whose count changed are uploaded, so a move costs O(n) texels and a
+// frame one quad whatever the board size.
+void drawThreats()
+{
+    int rows = threatMap.rows();
+    int cols = threatMap.cols();
+    bool fresh = threatTexture == 0;
+    if (fresh)
+    {
+        glGenTextures(1, &threatTexture);
+        glBindTexture(GL_TEXTURE_2D, threatTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    }
+    glBindTexture(GL_TEXTURE_2D, threatTexture);
+    if (fresh || threatMap.allChanged())
+    {
+        std::vector<uint8_t> texels(static_cast<size_t>(rows) * cols * 4);
+        for (int row = 0; row < rows; row++)
+        {
+            for (int col = 0; col < cols; col++)
+                threatTexel(row, col, &texels[(row * cols + col) * 4]);
+        }
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cols, rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    }
+    else
+    {
+        for (int square : threatMap.changes())
+        {
+            uint8_t texel[4];
+            threatTexel(square / cols, square % cols, texel);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, square % cols, square / cols, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+        }
+    }
+    threatMap.clearChanges();
+
+    float left = -BOARD_SIZE * SQUARE_SIZE / 2;
+    float right = BOARD_SIZE * SQUARE_SIZE / 2;
+    float height = tableTopHeight + 0.123f; // between the board and the highlights
+    glDisable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f);
+    glVertex3f(left, height, left);
+    glTexCoord2f(1.0f, 0.0f);
+    glVertex3f(right, height, left);
+    glTexCoord2f(1.0f, 1.0f);
+    glVertex3f(right, height, right);
+    glTexCoord2f(0.0f, 1.0f);
+    glVertex3f(left, height, right);
+    glEnd();
+    glDisable(GL_BLEND);
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_LIGHTING);
+}
+
+// Colors each free square from red (no solutions left) to green (most
+// solutions); squares still being counted fade in as their results arrive
+void drawHeatmap()
+{
+    int64_t maximum = viabilityHeatmap.maxCount();
+    bool complete = viabilityHeatmap.complete();
+
+    glDisable(GL_LIGHTING);
     glDisable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glPushMatrix();
+    glTranslatef(-SQUARE_SIZE * BOARD_SIZE / 2, tableTopHeight + 0.124f, -SQUARE_SIZE * BOARD_SIZE / 2);
+    glBegin(GL_QUADS);
+    for (int row = 0; row < BOARD_SIZE; row++)
+    {
+        for (int col = 0; col < BOARD_SIZE; col++)
+        {
+            int64_t count = viabilityHeatmap.count(row, col);
+            if (count == ViabilityHeatmap::UNAVAILABLE || (count == 0 && !complete))
+            {
+                continue;
+            }
+            float t = maximum > 0 ? static_cast<float>(count) / maximum : 0.0f;
+            glColor4f(1.0f - t, t, 0.0f, complete ? 0.45f : 0.3f);
+            glVertex3f(col * SQUARE_SIZE, 0, row * SQUARE_SIZE);
+            glVertex3f((col + 1) * SQUARE_SIZE, 0, row * SQUARE_SIZE);
+            glVertex3f((col + 1) * SQUARE_SIZE, 0, (row + 1) * SQUARE_SIZE);
+            glVertex3f(col * SQUARE_SIZE, 0, (row + 1) * SQUARE_SIZE);
+        }
+    }
+    glEnd();
+    glPopMatrix();
+
+    glDisable(GL_BLEND);
+    glEnable(GL_LIGHTING);
+}
+
+// Keeps redrawing while the heatmap workers are still publishing counts
+void refreshHeatmap(int value)
+{
+    glutPostRedisplay();
+    if (showHeatmap && !viabilityHeatmap.complete())
+    {
+        glutTimerFunc(16, refreshHeatmap, 0);
+        return;
+    }
+    heatmapRefreshing = false;
+}
+
+void startHeatmapRefresh()
+{
+    if (showHeatmap && !heatmapRefreshing)
+    {
+        heatmapRefreshing = true;
+        glutTimerFunc(16, refreshHeatmap, 0);
+    }
 }
 
 // Function to draw the queen model
@@ -812,8 +1320,8 @@ void playWinSound()
 // Modified placeQueen function
 void placeQueen(int row, int col)
 {
-    if (gameWon)
-        return; // Stop input if game is won
+    if (gameWon || isSolving || isReplaying || isAnimating)
+        return; // Stop input if game is won, the computer is playing or a queen is still landing
 
     float x = (col - BOARD_SIZE / 2 + 0.5f) * SQUARE_SIZE - 0.085f; // Adjust for edge
     float z = (row - BOARD_SIZE / 2 + 0.5f) * SQUARE_SIZE - 0.085f; // Adjust for edge
@@ -825,19 +1333,26 @@ void placeQueen(int row, int col)
     animationStartPos = queens.empty() ? std::make_pair(row, col) : queens.back();
     animationEndPos = std::make_pair(row, col);
 
-    // The queen will be added to the queens vector after the animation completes
+    // Every record of the position takes the queen now; the animation only
+    // draws it flying in
+    queens.push_back({row, col});
+    board.place(row, col);
+    variantBoard.place(row, col);
+    threatMap.place(row, col);
+    updateCompletions(board);
+    updatePlayerCompletion(queens);
 
     undoStack.push_back({row, col});
     glutPostRedisplay();
 
     // Start the animation timer
-    glutTimerFunc(16, animateQueen, 0); // 60 FPS
+    glutTimerFunc(16, animateQueen, ++animationGeneration); // 60 FPS
 
     // Play queen placed sound effect
     playPlacementSound();
 
     // Check if the game is won after placing the queen
-    if (queens.size() == 7 && isValidMove(row, col))
+    if (static_cast<int>(queens.size()) == gameVariant.rows)
     {
         gameWon = true;
         winSoundPlayed = false; // Reset the flag
@@ -856,8 +1371,13 @@ void cleanupOpenAL()
     alcCloseDevice(device);
 }
 
-void animateQueen(int value)
+void animateQueen(int generation)
 {
+    if (!isAnimating || generation != animationGeneration)
+    {
+        return; // The board was reset under the animation
+    }
+
     float currentTime = glutGet(GLUT_ELAPSED_TIME);
     float t = (currentTime - animationStartTime) / ANIMATION_DURATION;
 
@@ -865,9 +1385,8 @@ void animateQueen(int value)
     {
         // Animation complete
         isAnimating = false;
-        queens.push_back(animationEndPos);
 
-        if (queens.size() == 8)
+        if (gameWon && static_cast<int>(queens.size()) == gameVariant.rows)
         {
             gameWon = true;
             if (!isComputerSolved) // Only update high score if not solved by computer
@@ -890,7 +1409,7 @@ void animateQueen(int value)
     else
     {
         // Continue animation
-        glutTimerFunc(16, animateQueen, 0);
+        glutTimerFunc(16, animateQueen, generation);
     }
 
     glutPostRedisplay();
@@ -915,8 +1434,15 @@ void drawGuide()
     std::string guideText[] = {
         "Mouse LMB + Drag: Rotate",
         "Left click to place a queen. Press 'U': Undo",
-        "Press 'R': Restart",
-        "Press 'S': Auto-solve",
+        "Press 'R': Restart. Press 'G': Start from a random seeded layout",
+        "Press 'P': Puzzle with exactly one solution",
+        "Press 'S': Auto-solve (again to jump to the answer). Press '+'/'-': Solve speed",
+        "Press 'C': Count all solutions",
+        "Press 'N': Show next solution. Press 'H': Hint",
+        "Press 'V': Viability heatmap. Press 'A': Attacked squares",
+        "Press 'M': Toroidal/superqueen variants. Press 'B': Fewer rows",
+        "Press 'T': Replay a search trace ([ ] seek, < > solutions, space pause)",
+        "Press 'X': Queens in a cube of 8 boards ('L': next layer, 'S': solve)",
         "Press 'ESC': Exit"};
 
     glPushMatrix();
@@ -952,6 +1478,26 @@ void drawScore()
     glColor3f(1.0f, 1.0f, 0.2f); //  color for the score
     renderBitmapString(-1.6f, tableTopHeight + thickness + 0.3f, 0.0f, GLUT_BITMAP_HELVETICA_18, scoreText.str().c_str());
 
+    if (!gameVariant.isClassic())
+    {
+        std::string variantText = "Variant: " + describeVariant(gameVariant) + ", " + std::to_string(variantSolutions) +
+                                  " solutions ('M'/'B' to change)";
+        renderBitmapString(-1.6f, tableTopHeight + thickness + 0.4f, 0.0f, GLUT_BITMAP_HELVETICA_18, variantText.c_str());
+    }
+
+    std::string completionText = "Completions left: " + std::to_string(remainingCompletions);
+    renderBitmapString(-1.6f, tableTopHeight + thickness + 0.2f, 0.0f, GLUT_BITMAP_HELVETICA_18, completionText.c_str());
+
+    // Counters of the search behind the board: the auto-solver while it runs
+    // (and after it finishes), otherwise the last completion hint search
+    bool showSolverStats = isSolving || isComputerSolved;
+    const SolverStats &stats = showSolverStats ? stepSolver.stats() : completionSolver.stats();
+    if (STATS_ENABLED)
+    {
+        std::string statsText = (showSolverStats ? "Auto-solve: " : "Hint search: ") + statsSummary(stats);
+        renderBitmapString(-1.6f, tableTopHeight + thickness + 0.1f, 0.0f, GLUT_BITMAP_HELVETICA_12, statsText.c_str());
+    }
+
     // Display high score at the top right
     glPushMatrix();
     glLoadIdentity();
@@ -965,6 +1511,28 @@ void drawScore()
     std::string highScoreText = "Best Score: " + std::to_string(highScore);
     renderBitmapString(WINDOW_WIDTH - 150, WINDOW_HEIGHT - 20, 0.0f, GLUT_BITMAP_HELVETICA_18, highScoreText.c_str());
 
+    // Nodes per depth of the same search, one bar per row under the high score
+    int deepest = STATS_ENABLED ? stats.deepest() : -1;
+    if (deepest >= 0)
+    {
+        uint64_t widest = 1;
+        for (int depth = 0; depth <= deepest; depth++)
+            widest = std::max(widest, stats.depthNodes[depth]);
+        float barHeight = std::min(8.0f, 160.0f / (deepest + 1));
+        glColor3f(0.3f, 0.7f, 1.0f);
+        glBegin(GL_QUADS);
+        for (int depth = 0; depth <= deepest; depth++)
+        {
+            float width = 120.0f * stats.depthNodes[depth] / widest;
+            float top = WINDOW_HEIGHT - 40 - depth * barHeight;
+            glVertex2f(WINDOW_WIDTH - 150, top);
+            glVertex2f(WINDOW_WIDTH - 150 + width, top);
+            glVertex2f(WINDOW_WIDTH - 150 + width, top - barHeight + 1);
+            glVertex2f(WINDOW_WIDTH - 150, top - barHeight + 1);
+        }
+        glEnd();
+    }
+
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
@@ -1329,17 +1897,7 @@ bool fileExists(const std::string &filename)
 
 bool isValidMove(int row, int col)
 {
-    //  (row, col) is valid
-    for (const auto &queen : queens)
-    {
-        int qRow = queen.first;
-        int qCol = queen.second;
-        if (qRow == row || qCol == col || abs(qRow - row) == abs(qCol - col))
-        {
-            return false;
-        }
-    }
-    return true;
+    return threatMap.isFree(row, col);
 }
 
 // Save
@@ -1369,57 +1927,520 @@ void saveHighScore()
     }
 }
 
-bool solveQueens(int col)
+// Starts an animated backtracking search; solveTick() advances it a few
+// steps at a time so the GLUT loop keeps running
+void autoSolve()
+{
+    resetBoard();
+    isSolving = true;
+    isComputerSolved = true;
+
+    stepSolver.reset(BOARD_SIZE);
+    solveBudget = 0.0;
+    lastSolveTick = glutGet(GLUT_ELAPSED_TIME);
+    changeSolveSpeed(0);
+    glutTimerFunc(solveDelay, solveTick, ++solveGeneration);
+    glutPostRedisplay();
+}
+
+// Abandons the animated search and puts down the placement findPlacement
+// returns at once; on 8x8 that is backtracking, so the same first solution
+// the animation was heading for
+void finishSolve()
+{
+    std::vector<int> placement;
+    SolveResult result = findPlacement(BOARD_SIZE, placement);
+    isSolving = false;
+    solveGeneration++;
+    if (!result.found)
+    {
+        return;
+    }
+    std::cout << "Auto-solve finished by " << strategyName(result.strategy) << " ("
+              << result.nodes << " placements)" << std::endl;
+    loadSolution(placement);
+    glutPostRedisplay();
+}
+
+// Steps the solver by the time-based budget, capped so a stalled frame does
+// not turn into one huge batch, then mirrors its stack onto the board
+void solveTick(int generation)
 {
-    if (col >= BOARD_SIZE)
+    if (!isSolving || generation != solveGeneration)
     {
-        return true; // All queens are placed successfully
+        return; // Solve was reset or restarted
     }
 
-    for (int row = 0; row < BOARD_SIZE; row++)
+    int now = glutGet(GLUT_ELAPSED_TIME);
+    int speed = SOLVE_SPEEDS[solveSpeed];
+    solveBudget += speed * (now - lastSolveTick) / 1000.0;
+    lastSolveTick = now;
+    double cap = speed / 10.0 + 1.0;
+    if (solveBudget > cap)
+    {
+        solveBudget = cap;
+    }
+
+    uint64_t steps = static_cast<uint64_t>(solveBudget);
+    solveBudget -= stepSolver.run(steps);
+
+    showPlacement(stepSolver.placement(), stepSolver.depth());
+
+    if (stepSolver.finished())
     {
-        if (isValidMove(row, col))
+        isSolving = false;
+        std::cout << "Auto-solve finished after " << stepSolver.steps() << " steps ("
+                  << stepSolver.nodes() << " placements)" << std::endl;
+        if (stepSolver.lastEvent() == SOLVE_SOLVED)
         {
-            queens.push_back({row, col});
+            gameWon = true;
+            playWinSound();
+            winSoundPlayed = true;
+        }
+        updateCompletions(board);
+    }
+    else
+    {
+        glutTimerFunc(solveDelay, solveTick, generation);
+    }
+    glutPostRedisplay();
+}
 
-            if (solveQueens(col + 1))
-            {
-                return true;
-            }
+// Starts or stops the trace replay. The trace is opened on first use; when
+// the default file does not exist yet, the full 8x8 search is recorded to it.
+void toggleReplay()
+{
+    if (isReplaying)
+    {
+        resetBoard();
+        return;
+    }
+    if (!replayTrace.isOpen() && !replayTrace.open(replayPath))
+    {
+        if (!fileExists(replayPath))
+        {
+            TraceRecording recording = recordSearchTrace(replayPath, BOARD_SIZE, true);
+            if (recording.ok)
+                std::cout << "Recorded " << recording.events << " events of the " << BOARD_SIZE << "x" << BOARD_SIZE
+                          << " search to " << replayPath << std::endl;
+        }
+        if (!replayTrace.open(replayPath))
+        {
+            std::cerr << replayTrace.error() << std::endl;
+            return;
+        }
+    }
 
-            // If placing queen in the current position doesn't lead to a solution,
-            // remove the queen and try the next row
-            queens.pop_back();
+    resetBoard();
+    isReplaying = true;
+    replayPaused = false;
+    replayCursor.rewind();
+    replayBudget = 0.0;
+    lastReplayTick = glutGet(GLUT_ELAPSED_TIME);
+    std::cout << "Replaying " << replayPath << ": " << replayTrace.size() << " events, "
+              << replayTrace.solutions() << " solutions of the " << replayTrace.boardSize() << "x"
+              << replayTrace.boardSize() << " board" << std::endl;
+    glutTimerFunc(REPLAY_FRAME_MS, replayTick, ++replayGeneration);
+}
+
+// Puts the cursor's board on the 3D board when the sizes match
+void mirrorReplay()
+{
+    if (replayTrace.boardSize() != BOARD_SIZE)
+    {
+        return;
+    }
+    showPlacement(replayCursor.placement(), replayCursor.depth());
+}
+
+// Applies the events owed since the last frame in one go; only the board
+// they end on is drawn
+void replayTick(int generation)
+{
+    if (!isReplaying || generation != replayGeneration)
+    {
+        return;
+    }
+
+    int now = glutGet(GLUT_ELAPSED_TIME);
+    if (!replayPaused && !replayCursor.atEnd())
+    {
+        int speed = SOLVE_SPEEDS[solveSpeed];
+        replayBudget += speed * (now - lastReplayTick) / 1000.0;
+        replayBudget = std::min(replayBudget, speed / 10.0 + 1.0);
+        replayBudget -= replayCursor.advance(static_cast<uint64_t>(replayBudget));
+        mirrorReplay();
+    }
+    lastReplayTick = now;
+    glutPostRedisplay();
+    glutTimerFunc(REPLAY_FRAME_MS, replayTick, generation);
+}
+
+// Moves the replay by a number of events, either way, through the keyframes
+void seekReplay(int64_t events)
+{
+    if (!isReplaying)
+    {
+        return;
+    }
+    int64_t target = static_cast<int64_t>(replayCursor.position()) + events;
+    replayCursor.seek(static_cast<uint64_t>(std::max<int64_t>(0, target)));
+    replayBudget = 0.0;
+    mirrorReplay();
+}
+
+// Jumps to the moment the next (or previous) solution is completed
+void seekReplaySolution(int direction)
+{
+    if (!isReplaying || replayTrace.solutions() == 0)
+    {
+        return;
+    }
+    // solutions() counts those completed up to here, so it is also the
+    // number of the next one; on a solved board the shown one is behind it
+    uint64_t next = replayCursor.solutions();
+    uint64_t back = replayCursor.depth() == replayTrace.boardSize() ? 2 : 1;
+    uint64_t target;
+    if (direction > 0)
+        target = std::min(next, replayTrace.solutions() - 1);
+    else
+        target = next >= back ? next - back : 0;
+    replayCursor.seekSolution(target);
+    replayPaused = true;
+    replayBudget = 0.0;
+    mirrorReplay();
+}
+
+// The replayed board in the lower left corner, with the square of the last
+// event marked (yellow placed, red removed) and a progress bar underneath
+void drawReplay()
+{
+    const float PANEL = 240.0f;
+    const float LEFT = 10.0f;
+    const float BOTTOM = 60.0f;
+    int n = replayTrace.boardSize();
+    float cell = PANEL / n;
+
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0.0, WINDOW_WIDTH, 0.0, WINDOW_HEIGHT);
+    glMatrixMode(GL_MODELVIEW);
+    glDisable(GL_DEPTH_TEST);
+
+    // Row 0 at the top, as on the 3D board seen from the default camera
+    auto square = [&](int row, int col, float inset)
+    {
+        float x = LEFT + col * cell + inset;
+        float y = BOTTOM + PANEL - (row + 1) * cell + inset;
+        glVertex2f(x, y);
+        glVertex2f(x + cell - 2 * inset, y);
+        glVertex2f(x + cell - 2 * inset, y + cell - 2 * inset);
+        glVertex2f(x, y + cell - 2 * inset);
+    };
+    glBegin(GL_QUADS);
+    for (int row = 0; row < n; row++)
+    {
+        for (int col = 0; col < n; col++)
+        {
+            float shade = (row + col) % 2 ? 0.35f : 0.8f;
+            glColor3f(shade, shade, shade);
+            square(row, col, 0.0f);
         }
     }
+    TraceEvent last = replayCursor.lastEvent();
+    if (last.row >= 0)
+    {
+        if (last.removed)
+            glColor3f(1.0f, 0.2f, 0.2f);
+        else
+            glColor3f(1.0f, 1.0f, 0.0f);
+        square(last.row, last.col, 0.0f);
+    }
+    glColor3f(0.6f, 0.0f, 0.6f);
+    for (int row = 0; row < replayCursor.depth(); row++)
+    {
+        square(row, replayCursor.placement()[row], cell * 0.2f);
+    }
 
-    return false; // No solution found for this column
+    float done = replayTrace.size() ? static_cast<float>(replayCursor.position()) / replayTrace.size() : 1.0f;
+    glColor3f(0.25f, 0.25f, 0.25f);
+    glVertex2f(LEFT, BOTTOM - 16);
+    glVertex2f(LEFT + PANEL, BOTTOM - 16);
+    glVertex2f(LEFT + PANEL, BOTTOM - 8);
+    glVertex2f(LEFT, BOTTOM - 8);
+    glColor3f(0.2f, 0.8f, 1.0f);
+    glVertex2f(LEFT, BOTTOM - 16);
+    glVertex2f(LEFT + PANEL * done, BOTTOM - 16);
+    glVertex2f(LEFT + PANEL * done, BOTTOM - 8);
+    glVertex2f(LEFT, BOTTOM - 8);
+    glEnd();
+
+    std::ostringstream status;
+    status << "Replay " << replayCursor.position() << " / " << replayTrace.size() << " events, "
+           << replayCursor.solutions() << " solutions, " << SOLVE_SPEEDS[solveSpeed] << " events/s"
+           << (replayPaused ? " (paused)" : "");
+    glColor3f(1.0f, 1.0f, 1.0f);
+    renderBitmapString(LEFT, BOTTOM - 34, 0.0f, GLUT_BITMAP_HELVETICA_12, status.str().c_str());
+
+    glEnable(GL_DEPTH_TEST);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glEnable(GL_TEXTURE_2D);
+    glEnable(GL_LIGHTING);
 }
 
-void autoSolve()
+// Moves the solve speed one notch up or down; slow speeds tick once per step,
+// fast ones every frame with a larger batch
+void changeSolveSpeed(int direction)
 {
+    solveSpeed = std::max(0, std::min(SOLVE_SPEED_COUNT - 1, solveSpeed + direction));
+    solveDelay = std::max(16, 1000 / SOLVE_SPEEDS[solveSpeed]);
+}
+
+// Puts a complete solution on the board
+void loadSolution(const std::vector<int> &placement)
+{
+    showPlacement(placement.data(), BOARD_SIZE);
+    gameWon = true;
+    playWinSound();
+    winSoundPlayed = true;
+    updateCompletions(board);
+}
+
+// Asks the oracle how many solutions extend `position` (memoized, so
+// revisiting a board after an undo is a single lookup) and restarts the
+// heatmap counts for it
+void updateCompletions(const Bitboard &position)
+{
+    if (!gameVariant.isClassic())
+    {
+        // The oracle and the heatmap know the classic board only; a variant
+        // counts its completions with the attack-table search instead
+        remainingCompletions = countVariantCompletions(variantBoard);
+        isDeadEnd = remainingCompletions == 0 && static_cast<int>(variantBoard.pieces().size()) < gameVariant.rows;
+        if (isDeadEnd)
+        {
+            std::cout << "Dead end: no " << describeVariant(gameVariant) << " solution contains these pieces." << std::endl;
+        }
+        return;
+    }
+
+    remainingCompletions = completionOracle.completions(position);
+    viabilityHeatmap.update(position);
+    startHeatmapRefresh();
+    int placed = __builtin_popcountll(position.rows);
+    isDeadEnd = remainingCompletions == 0 && placed < BOARD_SIZE;
+    if (isDeadEnd)
+    {
+        std::cout << "Dead end: no solution contains these queens." << std::endl;
+    }
+}
+
+// Completes the player's queens with the MRV forward-checking search. Dead
+// ends are already known from the oracle, so they skip the search.
+void updatePlayerCompletion(const std::vector<std::pair<int, int>> &layout)
+{
+    playerCompletion.clear();
+    if (isDeadEnd)
+    {
+        return;
+    }
+    if (!gameVariant.isClassic())
+    {
+        std::vector<int> placement(gameVariant.rows);
+        if (completeVariant(variantBoard, placement.data()))
+            playerCompletion = placement;
+        return;
+    }
+
+    BoardConstraints constraints;
+    constraints.n = BOARD_SIZE;
+    constraints.queens = layout;
+    std::vector<int> placement(BOARD_SIZE);
+    if (completionSolver.solve(constraints, placement.data(), nullptr, COMPLETION_NODE_LIMIT))
+    {
+        playerCompletion = placement;
+    }
+}
+
+// Builds the solution index the first time the browser or sampler needs it
+void ensureSolutionIndex()
+{
+    if (!solutionIndex.ready())
+    {
+        solutionIndex.build(BOARD_SIZE, std::min(BOARD_SIZE, 4));
+    }
+}
+
+// Cycles through every solution in lexicographic order. Each one is unranked
+// from the solution index, so no earlier solutions are enumerated.
+void showNextSolution()
+{
+    ensureSolutionIndex();
+    if (solutionIndex.total() == 0)
+    {
+        return;
+    }
+
+    shownSolution = (shownSolution + 1) % static_cast<int64_t>(solutionIndex.total());
+    std::vector<int> solution(BOARD_SIZE);
+    solutionIndex.unrank(static_cast<uint64_t>(shownSolution), solution.data());
+
     resetBoard();
-    isSolving = true;
     isComputerSolved = true;
+    loadSolution(solution);
+    std::cout << "Solution " << shownSolution + 1 << " of " << solutionIndex.total();
+    if (BOARD_SIZE == TABLE_BOARD_SIZE)
+    {
+        std::cout << " (fundamental class " << EIGHT_QUEENS.classOf[shownSolution] + 1 << " of "
+                  << TABLE_FUNDAMENTAL_COUNT << ")";
+    }
+    std::cout << std::endl;
+    glutPostRedisplay();
+}
 
-    if (solveQueens(0))
+// Highlights a square that leads to a solution from the current board. The
+// 8x8 board looks the solution up in the compile-time table; other sizes use
+// the completion found when the last queen was placed.
+void showHintMove()
+{
+    if (gameWon)
     {
-        gameWon = true;
-        playWinSound();
-        winSoundPlayed = true;
+        return;
     }
 
-    isSolving = false;
+    showHint = true;
+    hintTimer = glutGet(GLUT_ELAPSED_TIME);
+    hintMessage.clear();
+
+    const int *solution = nullptr;
+    std::vector<int> tableSolution;
+    if (BOARD_SIZE == TABLE_BOARD_SIZE && gameVariant.isClassic())
+    {
+        int rows[TABLE_BOARD_SIZE];
+        int cols[TABLE_BOARD_SIZE];
+        int count = 0;
+        for (const auto &queen : queens)
+        {
+            rows[count] = queen.first;
+            cols[count] = queen.second;
+            count++;
+        }
+        int index = findTableSolution(rows, cols, count);
+        if (index >= 0)
+        {
+            tableSolution.assign(EIGHT_QUEENS.solutions[index].begin(), EIGHT_QUEENS.solutions[index].end());
+            solution = tableSolution.data();
+        }
+    }
+    else if (!playerCompletion.empty())
+    {
+        solution = playerCompletion.data();
+    }
+
+    if (!solution)
+    {
+        hintMessage = "No solution uses these queens. Undo a move.";
+        glutPostRedisplay();
+        return;
+    }
+
+    for (int row = 0; row < gameVariant.rows; row++)
+    {
+        if (!((board.rows >> row) & 1ULL))
+        {
+            hintSquare = {row, solution[row]};
+            break;
+        }
+    }
     glutPostRedisplay();
 }
 
-void highlightSquare(int row, int col)
+// Counts every solution for the board on all cores and reports it on the console
+void countAllSolutions()
 {
+    auto start = std::chrono::steady_clock::now();
+    ParallelCountResult result = countVariantSolutions(gameVariant);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << describeVariant(gameVariant) << " board: " << result.solutions << " solutions, "
+              << result.nodes << " nodes in " << std::fixed << std::setprecision(3) << seconds * 1000.0
+              << " ms on " << result.threads << " threads" << std::endl;
+}
+
+// Switches the game to another variant: rebuilds the attack table, counts the
+// variant's solutions once for the HUD and clears the board
+void selectVariant(VariantKind kind, int rows)
+{
+    gameVariant.kind = kind;
+    gameVariant.rows = rows;
+    gameVariant.cols = BOARD_SIZE;
+    variantTable = AttackTable(gameVariant);
+    variantSolutions = countVariantSolutions(gameVariant).solutions;
+    std::cout << "Variant: " << describeVariant(gameVariant) << ", " << variantSolutions << " solutions" << std::endl;
+    showHeatmap = false;
+    resetBoard();
+}
+
+// Brings the board to one queen per row at placement[0..depth): the queens
+// past the prefix both share come off (last first) and the new ones go down,
+// so a solver or replay step only moves the rows it changed on the board,
+// the variant board and the threat map
+void showPlacement(const int *placement, int depth)
+{
+    size_t keep = 0;
+    while (keep < queens.size() && static_cast<int>(keep) < depth &&
+           queens[keep] == std::make_pair(static_cast<int>(keep), placement[keep]))
+    {
+        keep++;
+    }
+    while (queens.size() > keep)
+    {
+        board.remove(queens.back().first, queens.back().second);
+        variantBoard.remove(queens.back().first, queens.back().second);
+        threatMap.remove(queens.back().first, queens.back().second);
+        queens.pop_back();
+    }
+    for (int row = static_cast<int>(keep); row < depth; row++)
+    {
+        queens.push_back({row, placement[row]});
+        board.place(row, placement[row]);
+        variantBoard.place(row, placement[row]);
+        threatMap.place(row, placement[row]);
+    }
+}
+
+// Auto-solve, the solution browser, seeded starts, puzzles, the heatmap and
+// replays are built on the classic solvers; true (with a note) on a variant
+bool needsClassicBoard()
+{
+    if (gameVariant.isClassic())
+    {
+        return false;
+    }
+    std::cout << "Only on the classic board: press 'M' until queens and 'B' until all 8 rows are back" << std::endl;
+    return true;
+}
+
+void highlightSquare(int row, int col, float red, float green, float blue, float height)
+{
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
     glPushMatrix();
     glTranslatef(-SQUARE_SIZE * BOARD_SIZE / 2 + SQUARE_SIZE / 2 + col * SQUARE_SIZE,
-                 0.01f, // Slightly above the board
+                 height, // Slightly above the board
                  -SQUARE_SIZE * BOARD_SIZE / 2 + SQUARE_SIZE / 2 + row * SQUARE_SIZE);
-    glColor4f(1.0f, 1.0f, 0.0f, 0.5f); // Yellow with 50% opacity
+    glColor4f(red, green, blue, 0.5f); // Yellow (by default) with 50% opacity
     glBegin(GL_QUADS);
     glVertex3f(-SQUARE_SIZE / 2, 0, -SQUARE_SIZE / 2);
     glVertex3f(SQUARE_SIZE / 2, 0, -SQUARE_SIZE / 2);
@@ -1427,6 +2448,155 @@ void highlightSquare(int row, int col)
     glVertex3f(-SQUARE_SIZE / 2, 0, SQUARE_SIZE / 2);
     glEnd();
     glPopMatrix();
+
+    glDisable(GL_BLEND);
+    glEnable(GL_LIGHTING);
+}
+
+// Switches between the flat board and the cube; either way starts empty
+void toggleCubeMode()
+{
+    cubeMode = !cubeMode;
+    if (cubeMode)
+    {
+        resetBoard(); // stops the flat board's solver, replay and animation
+        knownCubeMaximum(BOARD_SIZE, cubeTarget);
+        std::cout << "Cube mode: place " << cubeTarget << " queens in the " << BOARD_SIZE << "x" << BOARD_SIZE << "x"
+                  << BOARD_SIZE << " cube ('X' to leave)" << std::endl;
+    }
+    cubeBoard.clear();
+    activeLayer = 0;
+    cubeWon = false;
+    cubeComputerSolved = false;
+    numberOfTries = 0;
+}
+
+// Keys while in the cube; the flat board's keys wait until 'X' leaves it
+void cubeKeyboard(unsigned char key)
+{
+    switch (key)
+    {
+    case 'x':
+    case 'X':
+        toggleCubeMode();
+        break;
+    case 'r':
+    case 'R':
+        cubeBoard.clear();
+        cubeWon = false;
+        cubeComputerSolved = false;
+        numberOfTries = 0;
+        break;
+    case 'u':
+    case 'U':
+        if (!cubeBoard.queens().empty())
+        {
+            CubeQueen last = cubeBoard.queens().back();
+            cubeBoard.remove(last.layer, last.row, last.col);
+            cubeWon = false;
+        }
+        break;
+    case 'l':
+    case 'L':
+        activeLayer = (activeLayer + 1) % BOARD_SIZE;
+        break;
+    case 's':
+    case 'S':
+        solveGameCube();
+        break;
+    case 27: // ESC key
+        exit(0);
+        break;
+    default:
+        std::cout << "In the cube: 'L' layer, 'S' solve, 'U' undo, 'R' restart, 'X' back to the board" << std::endl;
+        break;
+    }
+    glutPostRedisplay();
+}
+
+void placeCubeQueen(int layer, int row, int col)
+{
+    if (cubeWon)
+        return;
+    cubeBoard.place(layer, row, col);
+    playPlacementSound();
+    if (static_cast<int>(cubeBoard.queens().size()) == cubeTarget)
+    {
+        cubeWon = true;
+        std::cout << "Congratulations! " << cubeTarget << " queens in the cube!" << std::endl;
+        playWinSound();
+    }
+}
+
+// Fills the cube with the most queens that fit (the parallel solver takes
+// well under a second for 8x8x8)
+void solveGameCube()
+{
+    CubeSolveOptions options;
+    options.n = BOARD_SIZE;
+    options.target = cubeTarget;
+    CubeSolveResult result = solveCube(options);
+    if (!result.found)
+    {
+        std::cout << "No placement of " << cubeTarget << " queens found" << std::endl;
+        return;
+    }
+    cubeBoard.clear();
+    for (const CubeQueen &queen : result.queens)
+    {
+        cubeBoard.place(queen.layer, queen.row, queen.col);
+    }
+    cubeWon = true;
+    cubeComputerSolved = true;
+    std::cout << "Cube solved: " << result.queens.size() << " queens, " << result.nodes << " nodes on "
+              << result.threads << " threads" << std::endl;
+}
+
+// Top of the board for a cube layer
+float layerHeight(int layer)
+{
+    return tableTopHeight + 0.12f + layer * CUBE_LAYER_GAP;
+}
+
+// The cube: its queens, then the boards bottom to top so each see-through
+// layer blends over what lies under it, then the squares of the active layer
+// that the queens already attack
+void drawCube()
+{
+    for (const CubeQueen &queen : cubeBoard.queens())
+    {
+        float x = (queen.col - BOARD_SIZE / 2 + 0.5f) * SQUARE_SIZE;
+        float z = (queen.row - BOARD_SIZE / 2 + 0.5f) * SQUARE_SIZE;
+        drawQueen(x, queen.layer * CUBE_LAYER_GAP, z);
+    }
+    for (int layer = 0; layer < BOARD_SIZE; layer++)
+    {
+        drawChessboard(layerHeight(layer), layer == activeLayer ? 1.0f : 0.35f);
+    }
+    for (int row = 0; row < BOARD_SIZE; row++)
+    {
+        for (int col = 0; col < BOARD_SIZE; col++)
+        {
+            if (!cubeBoard.canPlace(activeLayer, row, col))
+                highlightSquare(row, col, 1.0f, 0.2f, 0.2f, layerHeight(activeLayer) + 0.005f);
+        }
+    }
+
+    std::ostringstream cubeText;
+    cubeText << "Cube " << BOARD_SIZE << "x" << BOARD_SIZE << "x" << BOARD_SIZE << ": layer " << activeLayer + 1 << " of "
+             << BOARD_SIZE << ", " << cubeBoard.queens().size() << " of " << cubeTarget << " queens, "
+             << numberOfTries << " tries";
+    glDisable(GL_LIGHTING);
+    glColor3f(1.0f, 1.0f, 0.2f);
+    renderBitmapString(-1.6f, tableTopHeight + thickness + 0.3f, 0.0f, GLUT_BITMAP_HELVETICA_18, cubeText.str().c_str());
+    if (cubeWon)
+    {
+        glColor3f(0.2f, 1.0f, 0.2f);
+        renderBitmapString(-1.0f, layerHeight(BOARD_SIZE) + 0.2f, 0.0f, GLUT_BITMAP_HELVETICA_18,
+                           cubeComputerSolved ? "Solved by the computer. Press 'R' to start over."
+                                              : "Congratulations! You filled the cube!");
+    }
+    glEnable(GL_LIGHTING);
 }
 
 void clearHighlight()
@@ -1440,4 +2610,4 @@ void delay(int milliseconds)
     clock_t start_time = clock();
     while (clock() < start_time + milliseconds)
         ;
-}
\ No newline at end of file
+}
\ No newline at end of file
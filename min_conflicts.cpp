@@ -0,0 +1,184 @@
+#include "min_conflicts.h"
+
+#include <algorithm>
+#include <numeric>
+
+// xorshift64*: fast and good enough for picking swap partners
+struct FastRandom
+{
+    uint64_t state;
+
+    explicit FastRandom(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ULL) {}
+
+    uint64_t next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Uniform-enough value in [0, bound)
+    int below(int bound)
+    {
+        return static_cast<int>((next() >> 32) * static_cast<uint64_t>(bound) >> 32);
+    }
+};
+
+class ConflictBoard
+{
+public:
+    ConflictBoard(int n, std::vector<int> &placement)
+        : n(n), queens(placement), diagonals(2 * n - 1), antiDiagonals(2 * n - 1), collisions(0) {}
+
+    void clearCounters()
+    {
+        std::fill(diagonals.begin(), diagonals.end(), 0);
+        std::fill(antiDiagonals.begin(), antiDiagonals.end(), 0);
+        collisions = 0;
+    }
+
+    // Queens attacking (row, col) along its diagonals, the queen itself excluded
+    int attacksOn(int row, int col) const
+    {
+        return diagonals[row + col] + antiDiagonals[row - col + n - 1];
+    }
+
+    int conflictsOf(int row) const
+    {
+        return attacksOn(row, queens[row]) - 2;
+    }
+
+    void add(int row, int col)
+    {
+        if (diagonals[row + col]++ > 0)
+            collisions++;
+        if (antiDiagonals[row - col + n - 1]++ > 0)
+            collisions++;
+    }
+
+    void take(int row, int col)
+    {
+        if (--diagonals[row + col] > 0)
+            collisions--;
+        if (--antiDiagonals[row - col + n - 1] > 0)
+            collisions--;
+    }
+
+    // Swaps the columns of rows a and b if that lowers the number of attacks
+    bool trySwap(int a, int b)
+    {
+        int colA = queens[a];
+        int colB = queens[b];
+        take(a, colA);
+        take(b, colB);
+
+        int before = attacksOn(a, colA) + attacksOn(b, colB) + sharesDiagonal(a, colA, b, colB);
+        int after = attacksOn(a, colB) + attacksOn(b, colA) + sharesDiagonal(a, colB, b, colA);
+
+        if (after < before)
+        {
+            queens[a] = colB;
+            queens[b] = colA;
+        }
+        add(a, queens[a]);
+        add(b, queens[b]);
+        return after < before;
+    }
+
+    int n;
+    std::vector<int> &queens;
+    std::vector<int> diagonals;     // queens on diagonal row + col
+    std::vector<int> antiDiagonals; // queens on diagonal row - col + n - 1
+    uint64_t collisions;            // sum over diagonals of (queens - 1)
+
+private:
+    static int sharesDiagonal(int rowA, int colA, int rowB, int colB)
+    {
+        return (rowA + colA == rowB + colB ? 1 : 0) + (rowA - colA == rowB - colB ? 1 : 0);
+    }
+};
+
+// Fills the first rows by trying random remaining columns until one sits on
+// free diagonals; the last few rows, where free spots are rare, are placed as
+// they come and left to the repair phase.
+static void greedyPlacement(ConflictBoard &board, FastRandom &random)
+{
+    int n = board.n;
+    std::vector<int> &queens = board.queens;
+    std::iota(queens.begin(), queens.end(), 0);
+    board.clearCounters();
+
+    int tail = std::min(n, 50);
+    int row = 0;
+    for (; row < n - tail; row++)
+    {
+        for (int attempt = 0; attempt < 64; attempt++)
+        {
+            int pick = row + random.below(n - row);
+            std::swap(queens[row], queens[pick]);
+            if (board.attacksOn(row, queens[row]) == 0)
+                break;
+        }
+        board.add(row, queens[row]);
+    }
+    for (; row < n; row++)
+    {
+        int pick = row + random.below(n - row);
+        std::swap(queens[row], queens[pick]);
+        board.add(row, queens[row]);
+    }
+}
+
+MinConflictsResult solveMinConflicts(int n, std::vector<int> &placement, const MinConflictsOptions &options)
+{
+    MinConflictsResult result;
+    placement.assign(std::max(n, 0), 0);
+    if (n <= 0)
+    {
+        return result;
+    }
+
+    ConflictBoard board(n, placement);
+    FastRandom random(options.seed);
+
+    for (int restart = 0; restart <= options.maxRestarts; restart++)
+    {
+        result.restarts = restart;
+        greedyPlacement(board, random);
+
+        for (int pass = 0; pass < options.maxPassesPerRestart && board.collisions > 0; pass++)
+        {
+            bool improved = false;
+            for (int row = 0; row < n; row++)
+            {
+                if (board.conflictsOf(row) == 0)
+                    continue;
+
+                // Try a bounded number of random partners for this queen
+                for (int attempt = 0; attempt < 32; attempt++)
+                {
+                    int other = random.below(n);
+                    if (other == row)
+                        continue;
+                    result.swapsTried++;
+                    if (board.trySwap(row, other))
+                    {
+                        result.swapsMade++;
+                        improved = true;
+                        break;
+                    }
+                }
+            }
+            if (!improved)
+                break; // stuck in a local minimum
+        }
+
+        if (board.collisions == 0)
+        {
+            result.solved = true;
+            return result;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,29 @@
+#ifndef MIN_CONFLICTS_H
+#define MIN_CONFLICTS_H
+
+#include <cstdint>
+#include <vector>
+
+struct MinConflictsOptions
+{
+    uint64_t seed = 1;
+    int maxRestarts = 50;
+    int maxPassesPerRestart = 200; // sweeps over the conflicted queens before restarting
+};
+
+struct MinConflictsResult
+{
+    bool solved = false;
+    int restarts = 0;
+    uint64_t swapsTried = 0;
+    uint64_t swapsMade = 0;
+};
+
+// Local search for boards far beyond backtracking range. Queens are kept as a
+// permutation (placement[row] = col), so rows and columns never clash; the
+// queens on every diagonal are counted in flat arrays, which makes each
+// candidate swap an O(1) update. Starts from a greedy conflict-free-as-possible
+// placement and restarts with a new seed when it stalls. Memory is linear in n.
+MinConflictsResult solveMinConflicts(int n, std::vector<int> &placement, const MinConflictsOptions &options = MinConflictsOptions());
+
+#endif
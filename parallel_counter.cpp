@@ -0,0 +1,71 @@
+#include "parallel_counter.h"
+#include "solver.h"
+#include "solver_stats.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+// One cache line per worker so the counters never share a line
+struct alignas(64) WorkerCounters
+{
+    uint64_t solutions = 0;
+    uint64_t nodes = 0;
+    SolverStats stats;
+};
+
+void expandPrefixes(int n, uint64_t full, const SearchState &state, int depth, std::vector<SearchState> &out, uint64_t &nodes)
+{
+    if (depth == 0 || state.row == n)
+    {
+        out.push_back(state);
+        return;
+    }
+
+    uint64_t free = freeColumns(state, full);
+    while (free)
+    {
+        uint64_t bit = free & (0 - free);
+        free ^= bit;
+        nodes++;
+        expandPrefixes(n, full, advance(state, bit), depth - 1, out, nodes);
+    }
+}
+
+ParallelCountResult countSolutionsParallel(int n, int prefixDepth, int threadCount, CountEngine engine, SolverStats *stats)
+{
+    ParallelCountResult result = {0, 0, 0, 0};
+    if (n <= 0 || n > MAX_BOARD_SIZE)
+    {
+        return result;
+    }
+
+    std::vector<SearchState> prefixes;
+    expandPrefixes(n, boardMask(n), rootState(), std::max(0, std::min(prefixDepth, n)), prefixes, result.nodes);
+
+    WorkStealingPool pool(threadCount);
+    std::vector<WorkerCounters> counters(pool.threadCount());
+    bool instrumented = STATS_ENABLED && stats;
+    for (const SearchState &prefix : prefixes)
+    {
+        pool.submit([n, prefix, engine, instrumented, &counters](int worker)
+                    {
+                        WorkerCounters &local = counters[worker];
+                        if (instrumented)
+                            local.solutions += countCompletions(n, prefix, &local.nodes, &local.stats);
+                        else
+                            local.solutions += countCompletionsWith(engine, n, prefix, &local.nodes); });
+    }
+    pool.wait();
+
+    for (const WorkerCounters &local : counters)
+    {
+        result.solutions += local.solutions;
+        result.nodes += local.nodes;
+        if (instrumented)
+            stats->merge(local.stats);
+    }
+    result.tasks = static_cast<int>(prefixes.size());
+    result.threads = pool.threadCount();
+    return result;
+}
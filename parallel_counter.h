@@ -0,0 +1,31 @@
+#ifndef PARALLEL_COUNTER_H
+#define PARALLEL_COUNTER_H
+
+#include "simd_counter.h"
+
+#include <cstdint>
+#include <vector>
+
+struct ParallelCountResult
+{
+    uint64_t solutions;
+    uint64_t nodes; // queens placed, prefix expansion included
+    int tasks;      // number of prefix subtrees handed to the pool
+    int threads;
+};
+
+// Collects every search state `depth` rows below `state`, in lexicographic
+// order; nodes is increased by the queens placed on the way
+void expandPrefixes(int n, uint64_t full, const SearchState &state, int depth, std::vector<SearchState> &out, uint64_t &nodes);
+
+// Counts every solution of an n x n board. The first prefixDepth rows are
+// expanded into independent subtrees that a work-stealing pool of threadCount
+// workers (0 = one per hardware thread) searches; per-thread counters are
+// merged once the pool drains. engine picks the inner search (see simd_counter.h).
+// With stats the subtrees run the instrumented scalar search instead, and the
+// per-worker stats are merged in (their times add up across workers; prefix
+// expansion is not included).
+ParallelCountResult countSolutionsParallel(int n, int prefixDepth = 2, int threadCount = 0, CountEngine engine = ENGINE_AUTO,
+                                           SolverStats *stats = nullptr);
+
+#endif
@@ -0,0 +1,64 @@
+#include "placement_writer.h"
+
+void PlacementWriter::reserve(int bytes)
+{
+    if (used + bytes > BUFFER_SIZE)
+    {
+        flush();
+    }
+}
+
+void PlacementWriter::write(int value)
+{
+    reserve(12); // separator, sign and ten digits
+    if (lineStarted)
+    {
+        buffer[used++] = separator;
+    }
+    lineStarted = true;
+
+    unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    if (value < 0)
+    {
+        buffer[used++] = '-';
+    }
+
+    char digits[10];
+    int count = 0;
+    do
+    {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    while (count > 0)
+    {
+        buffer[used++] = digits[--count];
+    }
+}
+
+void PlacementWriter::text(const char *raw)
+{
+    for (; *raw != '\0'; raw++)
+    {
+        reserve(1);
+        buffer[used++] = *raw;
+    }
+    lineStarted = false;
+}
+
+void PlacementWriter::endLine()
+{
+    reserve(1);
+    buffer[used++] = '\n';
+    lineStarted = false;
+}
+
+void PlacementWriter::flush()
+{
+    if (used > 0)
+    {
+        out.write(buffer, used);
+        used = 0;
+    }
+}
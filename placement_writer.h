@@ -0,0 +1,36 @@
+#ifndef PLACEMENT_WRITER_H
+#define PLACEMENT_WRITER_H
+
+#include <ostream>
+
+// Streams placements through a fixed buffer, formatting each number in place
+// rather than building an intermediate string. Numbers on one line are joined
+// with `separator`.
+class PlacementWriter
+{
+public:
+    explicit PlacementWriter(std::ostream &out, char separator = ' ')
+        : out(out), separator(separator), used(0), lineStarted(false) {}
+    ~PlacementWriter() { flush(); }
+
+    PlacementWriter(const PlacementWriter &) = delete;
+    PlacementWriter &operator=(const PlacementWriter &) = delete;
+
+    void write(int value);
+    void text(const char *raw); // copied verbatim; the next number starts fresh
+    void endLine();
+    void flush();
+
+private:
+    static const int BUFFER_SIZE = 1 << 16;
+
+    void reserve(int bytes);
+
+    std::ostream &out;
+    char separator;
+    int used;
+    bool lineStarted; // a number is already on the current line
+    char buffer[BUFFER_SIZE];
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "propagation_solver.h"
+
+#include <cstddef>
+
+// Copies the domains of the open rows other than `row` from `from` to `to`
+// with the new queen's column and diagonals struck out. False on a wipe-out:
+// an open row left with no column, or a free column no open row can reach.
+bool PropagationSolver::assign(const uint64_t *from, uint64_t *to, uint64_t openRows, uint64_t freeCols, int row,
+                               uint64_t bit)
+{
+    uint64_t rest = openRows & ~(1ULL << row);
+    uint64_t reach = 0;
+    while (rest)
+    {
+        int other = lowestBit(rest);
+        rest &= rest - 1;
+        int distance = other > row ? other - row : row - other;
+        uint64_t domain = from[other] & ~(bit | (bit << distance) | (bit >> distance));
+        STATS_ADD(searchStats, checks, 1);
+        if (!domain)
+        {
+            return false;
+        }
+        to[other] = domain;
+        reach |= domain;
+    }
+    uint64_t needed = freeCols & ~bit;
+    return (reach & needed) == needed;
+}
+
+bool PropagationSolver::search(int depth, uint64_t openRows, uint64_t freeCols)
+{
+    if (!openRows)
+    {
+        STATS_ADD(searchStats, solutions, 1);
+        return ++found >= limit;
+    }
+
+    const uint64_t *current = &domains[static_cast<std::size_t>(depth) * n];
+    uint64_t *next = &domains[static_cast<std::size_t>(depth + 1) * n];
+
+    int row = lowestBit(openRows);
+    if (order == BRANCH_MRV)
+    {
+        int fewest = n + 1;
+        for (uint64_t rows = openRows; rows; rows &= rows - 1)
+        {
+            int candidate = lowestBit(rows);
+            int size = __builtin_popcountll(current[candidate]);
+            if (size < fewest)
+            {
+                fewest = size;
+                row = candidate;
+                if (size == 1)
+                    break; // forced move
+            }
+        }
+    }
+
+    uint64_t choices = current[row];
+    if (!choices)
+        STATS_ADD(searchStats, prunes, 1);
+    while (choices && visited < nodeLimit)
+    {
+        uint64_t bit = choices & (0 - choices);
+        choices ^= bit;
+        visited++;
+        STATS_NODE(searchStats, depth);
+        placement[row] = lowestBit(bit);
+        if (!assign(current, next, openRows, freeCols, row, bit))
+        {
+            STATS_ADD(searchStats, prunes, 1);
+            continue;
+        }
+        if (search(depth + 1, openRows & ~(1ULL << row), freeCols & ~bit))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t PropagationSolver::run(const BoardConstraints &constraints, int *out, uint64_t maxFound, uint64_t maxNodes,
+                                uint64_t *nodesOut)
+{
+    n = constraints.n;
+    placement = out;
+    found = 0;
+    limit = maxFound;
+    visited = 0;
+    nodeLimit = maxNodes;
+    searchStats.clear();
+    StatsTimer timer(&searchStats);
+    if (n < 1 || n > MAX_BOARD_SIZE || maxFound == 0)
+    {
+        return 0;
+    }
+
+    domains.assign(static_cast<std::size_t>(n + 1) * n, 0);
+    uint64_t *root = domains.data();
+    for (int row = 0; row < n; row++)
+    {
+        root[row] = boardMask(n);
+    }
+    for (const auto &square : constraints.blocked)
+    {
+        if (square.first < 0 || square.first >= n || square.second < 0 || square.second >= n)
+            return 0;
+        root[square.first] &= ~(1ULL << square.second);
+    }
+
+    // Pre-placed queens propagate like any other placement, in place on the
+    // root domains; a queen outside its row's domain clashes with an earlier one
+    uint64_t openRows = boardMask(n);
+    uint64_t freeCols = boardMask(n);
+    bool consistent = true;
+    for (const auto &queen : constraints.queens)
+    {
+        if (queen.first < 0 || queen.first >= n || queen.second < 0 || queen.second >= n)
+        {
+            consistent = false;
+            break;
+        }
+        uint64_t bit = 1ULL << queen.second;
+        if (!((openRows >> queen.first) & 1ULL) || !(root[queen.first] & bit) ||
+            !assign(root, root, openRows, freeCols, queen.first, bit))
+        {
+            consistent = false;
+            break;
+        }
+        placement[queen.first] = queen.second;
+        openRows &= ~(1ULL << queen.first);
+        freeCols &= ~bit;
+    }
+
+    if (consistent)
+    {
+        search(0, openRows, freeCols);
+    }
+    if (nodesOut)
+    {
+        *nodesOut += visited;
+    }
+    return found;
+}
+
+bool PropagationSolver::solve(const BoardConstraints &constraints, int *placementOut, uint64_t *nodesOut,
+                              uint64_t maxNodes)
+{
+    return run(constraints, placementOut, 1, maxNodes, nodesOut) > 0;
+}
+
+uint64_t PropagationSolver::count(const BoardConstraints &constraints, uint64_t maxFound, uint64_t *nodesOut)
+{
+    scratch.assign(constraints.n > 0 ? constraints.n : 0, 0);
+    return run(constraints, scratch.data(), maxFound, UINT64_MAX, nodesOut);
+}
@@ -0,0 +1,63 @@
+#ifndef PROPAGATION_SOLVER_H
+#define PROPAGATION_SOLVER_H
+
+#include "board_constraints.h"
+#include "solver_stats.h"
+#include "solver.h"
+
+#include <cstdint>
+#include <vector>
+
+// Which open row the propagation search branches on
+enum BranchOrder
+{
+    BRANCH_ROWS, // top to bottom, like solveQueens
+    BRANCH_MRV   // the row with the fewest columns left (minimum remaining values)
+};
+
+// Backtracking with forward checking. Every row keeps a bitset domain of the
+// columns still open to it; placing a queen strikes its column and diagonals
+// out of every open row's domain in O(n). A row whose domain empties, or a
+// free column that no open row can still reach, is a wipe-out and the search
+// backtracks at once instead of discovering the dead end rows later. Domains
+// for each depth live in one preallocated block, so the search allocates
+// nothing. Boards up to MAX_BOARD_SIZE.
+class PropagationSolver
+{
+public:
+    explicit PropagationSolver(BranchOrder order = BRANCH_MRV) : order(order) {}
+
+    void setOrder(BranchOrder next) { order = next; }
+
+    // First completion of `constraints` into placement[0..n); false when there
+    // is none, or after nodeLimit queens without one. nodes (optional) is
+    // increased by the number of queens placed, pre-placed queens excluded.
+    bool solve(const BoardConstraints &constraints, int *placement, uint64_t *nodes = nullptr,
+               uint64_t nodeLimit = UINT64_MAX);
+
+    // Completions of `constraints`, stopping once `limit` are found
+    uint64_t count(const BoardConstraints &constraints, uint64_t limit = UINT64_MAX, uint64_t *nodes = nullptr);
+
+    // Counters of the last solve() or count(). A check is one row domain
+    // filtered, a prune is a wipe-out (a placement undone by propagation
+    // before the search went any deeper) or an open row with no columns.
+    const SolverStats &stats() const { return searchStats; }
+
+private:
+    uint64_t run(const BoardConstraints &constraints, int *out, uint64_t maxFound, uint64_t maxNodes, uint64_t *nodesOut);
+    bool search(int depth, uint64_t openRows, uint64_t freeCols);
+    bool assign(const uint64_t *from, uint64_t *to, uint64_t openRows, uint64_t freeCols, int row, uint64_t bit);
+
+    BranchOrder order;
+    int n = 0;
+    std::vector<uint64_t> domains; // n words per depth, depth 0 first
+    int *placement = nullptr;
+    std::vector<int> scratch;      // count() completions land here
+    uint64_t found = 0;
+    uint64_t limit = 0;
+    uint64_t visited = 0;
+    uint64_t nodeLimit = 0;
+    SolverStats searchStats;
+};
+
+#endif
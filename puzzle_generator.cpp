@@ -0,0 +1,120 @@
+#include "puzzle_generator.h"
+#include "empty_row_search.h"
+#include "solution_sampler.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+uint64_t countCompletionsUpTo(int n, const std::vector<std::pair<int, int>> &clues, uint64_t limit, uint64_t *nodes)
+{
+    if (n < 1 || n > MAX_BOARD_SIZE || limit == 0)
+    {
+        return 0;
+    }
+
+    // Clues that attack each other leave nothing to complete
+    EmptyRowSearch s;
+    s.reset(n);
+    for (const auto &clue : clues)
+    {
+        if (!s.fix(clue.first, clue.second))
+        {
+            return 0;
+        }
+    }
+    s.listEmptyRows();
+
+    uint64_t found = 0;
+    auto countUpToLimit = [&found, limit](const EmptyRowSearch &)
+    {
+        return ++found >= limit;
+    };
+    s.run(countUpToLimit);
+    if (nodes)
+    {
+        *nodes += s.nodes;
+    }
+    return found;
+}
+
+const char *gradeName(PuzzleGrade grade)
+{
+    switch (grade)
+    {
+    case GRADE_EASY:
+        return "easy";
+    case GRADE_MEDIUM:
+        return "medium";
+    default:
+        return "hard";
+    }
+}
+
+Puzzle generatePuzzle(const SolutionIndex &index, uint64_t seed)
+{
+    Puzzle puzzle;
+    puzzle.n = index.boardSize();
+    puzzle.nodes = 0;
+    puzzle.grade = GRADE_EASY;
+
+    SolutionSampler sampler(index, seed);
+    puzzle.solution.assign(puzzle.n, 0);
+    if (!sampler.sample(puzzle.solution.data()))
+    {
+        puzzle.solution.clear();
+        return puzzle;
+    }
+
+    // Try the rows in random order; a clue stays only if dropping it would
+    // admit a second completion
+    std::vector<int> order(puzzle.n);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 random(seed ^ 0x9E3779B97F4A7C15ULL);
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<bool> kept(puzzle.n, true);
+    for (int row : order)
+    {
+        kept[row] = false;
+        std::vector<std::pair<int, int>> trial;
+        for (int r = 0; r < puzzle.n; r++)
+        {
+            if (kept[r])
+                trial.push_back({r, puzzle.solution[r]});
+        }
+        if (countCompletionsUpTo(puzzle.n, trial, 2) > 1)
+        {
+            kept[row] = true;
+        }
+    }
+
+    for (int row = 0; row < puzzle.n; row++)
+    {
+        if (kept[row])
+            puzzle.clues.push_back({row, puzzle.solution[row]});
+    }
+
+    // Grade by the search a solver needs: queens placed (dead ends included)
+    // while proving the completion unique, per queen it has to find and per
+    // column it could try, so the grades mean the same on every board size
+    countCompletionsUpTo(puzzle.n, puzzle.clues, 2, &puzzle.nodes);
+    int missing = puzzle.n - static_cast<int>(puzzle.clues.size());
+    double effort = missing > 0 ? static_cast<double>(puzzle.nodes) / missing / puzzle.n : 0.0;
+    puzzle.grade = effort < 0.5 ? GRADE_EASY : (effort < 1.5 ? GRADE_MEDIUM : GRADE_HARD);
+    return puzzle;
+}
+
+std::vector<Puzzle> generatePuzzles(const SolutionIndex &index, int count, uint64_t seed, int threadCount)
+{
+    std::vector<Puzzle> puzzles(count > 0 ? count : 0);
+    WorkStealingPool pool(threadCount);
+    for (int i = 0; i < count; i++)
+    {
+        pool.submit([&, i](int)
+                    { puzzles[i] = generatePuzzle(index, seed + i); });
+    }
+    pool.wait();
+    return puzzles;
+}
@@ -0,0 +1,45 @@
+#ifndef PUZZLE_GENERATOR_H
+#define PUZZLE_GENERATOR_H
+
+#include "solution_index.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+enum PuzzleGrade
+{
+    GRADE_EASY,   // the clues force almost every queen
+    GRADE_MEDIUM,
+    GRADE_HARD,   // solving needs real search
+    GRADE_COUNT
+};
+
+const char *gradeName(PuzzleGrade grade);
+
+// Pre-placed queens with exactly one completion
+struct Puzzle
+{
+    int n;
+    std::vector<std::pair<int, int>> clues; // (row, col), sorted by row
+    std::vector<int> solution;              // the unique completion, solution[row] = col
+    uint64_t nodes;                         // queens placed proving the completion unique
+    PuzzleGrade grade;
+};
+
+// Completions of the board holding `clues`, counting stops at `limit`.
+// limit 2 answers "none, one or several" without finishing the search.
+// nodes (optional) is increased by the queens placed.
+uint64_t countCompletionsUpTo(int n, const std::vector<std::pair<int, int>> &clues, uint64_t limit,
+                              uint64_t *nodes = nullptr);
+
+// One puzzle: a uniformly sampled solution whose queens are removed in random
+// order for as long as the rest still has a unique completion, so no clue of
+// the result can be dropped. The index must be built for n.
+Puzzle generatePuzzle(const SolutionIndex &index, uint64_t seed);
+
+// `count` puzzles generated on threadCount workers (0 = all cores). Puzzle i
+// uses seed + i, so a batch is reproducible whatever the thread count.
+std::vector<Puzzle> generatePuzzles(const SolutionIndex &index, int count, uint64_t seed, int threadCount = 0);
+
+#endif
@@ -0,0 +1,1356 @@
+// Headless N-queens solver and benchmark. Links only the solver sources, so it
+// runs on build hosts without GL, GLUT or OpenAL.
+#include "solver.h"
+#include "parallel_counter.h"
+#include "symmetry.h"
+#include "min_conflicts.h"
+#include "placement_writer.h"
+#include "constructive_solver.h"
+#include "solve_strategy.h"
+#include "simd_counter.h"
+#include "fixed_solver.h"
+#include "solution_archive.h"
+#include "solution_index.h"
+#include "solution_sampler.h"
+#include "puzzle_generator.h"
+#include "board_constraints.h"
+#include "dlx_solver.h"
+#include "propagation_solver.h"
+#include "solver_farm.h"
+#include "solver_stats.h"
+#include "search_trace.h"
+#include "board_variant.h"
+#include "cube_solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum OutputFormat
+{
+    FORMAT_TEXT,
+    FORMAT_CSV,
+    FORMAT_JSON
+};
+
+struct Options
+{
+    int n = 8;
+    std::string mode = "count";
+    int threads = 0;
+    int prefixDepth = 2;
+    OutputFormat format = FORMAT_TEXT;
+    bool quiet = false; // enumerate/local: skip printing the solutions
+    uint64_t seed = 1;
+    CountEngine engine = ENGINE_AUTO;
+    bool sizeGiven = false;
+    std::string archivePath;       // enumerate: write a binary archive; lookup: archive to read
+    bool fundamentalOnly = false;  // enumerate -o: keep one canonical form per class
+    uint64_t index = 0;            // lookup/unrank: solution to fetch
+    std::vector<int> placement;    // rank: the solution to look up
+    bool depthGiven = false;
+    int samples = 1;               // sample/puzzles: how many to produce
+    std::string indexPath;         // rank/unrank/sample: cached index file
+    int given = -1;                // complete: pre-placed queens, -1 = n / 4; cube: queens to place, -1 = maximum
+    int blocked = -1;              // complete: blocked squares, -1 = n * n / 8
+    std::string journalPath;       // farm: finished jobs are recorded here for resume
+    bool stats = false;            // first/count/complete: print the search counters
+    bool inputGiven = false;       // trace: -i replays an existing file instead of recording
+    uint64_t eventLimit = 0;       // trace: stop recording after this many events; cube: node limit; 0 = none
+    VariantKind variant = VARIANT_QUEENS; // first/count: pieces and wrapping
+    int cols = 0;                  // first/count: board width, 0 = n (square)
+};
+
+// The board first/count search: n rows, -w columns
+static BoardVariant boardVariant(const Options &options)
+{
+    BoardVariant variant;
+    variant.kind = options.variant;
+    variant.rows = options.n;
+    variant.cols = options.cols > 0 ? options.cols : options.n;
+    return variant;
+}
+
+struct RunReport
+{
+    bool found = false;
+    uint64_t solutions = 0;
+    uint64_t fundamental = 0;
+    uint64_t nodes = 0;
+    int restarts = 0;
+    int placementCheck = -1; // O(n) verifier on the produced placement: -1 not run, 0 failed, 1 passed
+    int threads = 1;
+    double seconds = 0.0;
+    uint64_t archived = 0; // records written to or held by the archive
+    uint32_t jobs = 0;     // farm: prefix jobs in the run
+    uint32_t resumed = 0;  // farm: jobs read back from the journal
+    int grades[GRADE_COUNT] = {}; // puzzles: how many of each grade
+    int64_t rank = -1;     // rank: position of the given solution
+    const char *strategy = nullptr; // auto: the strategy findPlacement ran
+    SolverStats stats;     // filled when options.stats is set
+    size_t frontier = 0;   // rank/unrank: prefixes cached by the index
+    double indexSeconds = 0.0;
+};
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  -n N            board size (1.." << MAX_BOARD_SIZE << ", any size for local/construct/auto; default 8)\n"
+              << "  -m MODE         first | count | enumerate | local | construct | auto | lookup | rank |\n"
+              << "                  unrank | sample | puzzles | engines | fixed | complete | farm | trace |\n"
+              << "                  cube (default count)\n"
+              << "  -t THREADS      worker threads for count (processes for farm), 0 = all cores (default 0)\n"
+              << "  -d DEPTH        rows expanded into parallel tasks (default 2; farm: 3; rank/unrank:\n"
+              << "                  rows whose subtree counts the index caches, default 4)\n"
+              << "  -e ENGINE       count inner loop: auto | scalar | avx2 (default auto)\n"
+              << "  -v VARIANT      first/count: queens | torus (diagonals wrap) | super (queen + knight)\n"
+              << "  -w COLS         first/count: board width, at least n (default n); one piece per row\n"
+              << "  -f FORMAT       text | csv | json (default text)\n"
+              << "  -s SEED         random seed for local search (default 1)\n"
+              << "  -q              print the report only, not the solutions\n"
+              << "  -S              first/count/complete: print checks, prunes, search time and nodes per\n"
+              << "                  depth (count then runs the scalar engine, which is the instrumented one)\n"
+              << "  -o FILE         enumerate: write the solutions to a binary archive instead of text;\n"
+              << "                  trace: record the search of every solution there (n defaults to 12)\n"
+              << "  -u              with -o: store one canonical solution per symmetry class\n"
+              << "  -i FILE         lookup: archive to read; trace: trace to check (n comes from the file)\n"
+              << "  -l EVENTS       trace: stop recording after EVENTS place/remove events (default: whole search);\n"
+              << "                  cube: give up after EVENTS queens placed or moved\n"
+              << "  -k INDEX        lookup/unrank: 0-based solution to print (default 0)\n"
+              << "  -p C0,C1,...    rank: the solution to number, one 0-based column per row\n"
+              << "  -c COUNT        sample/puzzles: how many to produce; complete: instances (default 1; seed with -s)\n"
+              << "  -g QUEENS       complete: queens pre-placed on each instance (default n / 4);\n"
+              << "                  cube: queens to place (default the most that fit, n * n past n = 11)\n"
+              << "  -b SQUARES      complete: squares blocked on each instance (default n * n / 8)\n"
+              << "  -x FILE         rank/unrank/sample: load the index from FILE, or build and save it there\n"
+              << "  -j FILE         farm: journal of finished jobs; rerunning with it resumes the count\n"
+              << "auto finds one placement with the fastest strategy for n: backtracking up to n = 12,\n"
+              << "the closed-form construction beyond\n"
+              << "engines compares the scalar and AVX2 count for N = 12..n (n defaults to 17)\n"
+              << "fixed compares Solver<N> with the runtime-N search for N = 4..n (n defaults to 15)\n"
+              << "complete solves random constrained boards with the row-order search, forward checking\n"
+              << "and dancing links (n defaults to 32)\n"
+              << "trace records a search trace (-o) or opens one (-i), replays it end to end and times\n"
+              << "random seeks against the replay\n"
+              << "cube places queens in an n x n x n cube, none attacking along the 13 lines through a\n"
+              << "square, and prints the layers bottom first (n defaults to 8, at most " << MAX_CUBE_SIZE << ")\n";
+}
+
+static bool parseInt(const char *text, int &value)
+{
+    char *end = nullptr;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0')
+    {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+static bool parseArguments(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "-n" && hasValue)
+        {
+            if (!parseInt(argv[++i], options.n))
+                return false;
+            options.sizeGiven = true;
+        }
+        else if (arg == "-m" && hasValue)
+        {
+            options.mode = argv[++i];
+        }
+        else if (arg == "-t" && hasValue)
+        {
+            if (!parseInt(argv[++i], options.threads))
+                return false;
+        }
+        else if (arg == "-d" && hasValue)
+        {
+            if (!parseInt(argv[++i], options.prefixDepth))
+                return false;
+            options.depthGiven = true;
+        }
+        else if (arg == "-e" && hasValue)
+        {
+            std::string engine = argv[++i];
+            if (engine == "auto")
+                options.engine = ENGINE_AUTO;
+            else if (engine == "scalar")
+                options.engine = ENGINE_SCALAR;
+            else if (engine == "avx2")
+                options.engine = ENGINE_AVX2;
+            else
+                return false;
+        }
+        else if (arg == "-f" && hasValue)
+        {
+            std::string format = argv[++i];
+            if (format == "text")
+                options.format = FORMAT_TEXT;
+            else if (format == "csv")
+                options.format = FORMAT_CSV;
+            else if (format == "json")
+                options.format = FORMAT_JSON;
+            else
+                return false;
+        }
+        else if (arg == "-s" && hasValue)
+        {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "-q")
+        {
+            options.quiet = true;
+        }
+        else if (arg == "-S")
+        {
+            options.stats = true;
+        }
+        else if ((arg == "-o" || arg == "-i") && hasValue)
+        {
+            options.inputGiven = arg == "-i";
+            options.archivePath = argv[++i];
+        }
+        else if (arg == "-v" && hasValue)
+        {
+            if (!parseVariantKind(argv[++i], options.variant))
+                return false;
+        }
+        else if (arg == "-w" && hasValue)
+        {
+            if (!parseInt(argv[++i], options.cols) || options.cols < 1)
+                return false;
+        }
+        else if (arg == "-l" && hasValue)
+        {
+            options.eventLimit = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "-u")
+        {
+            options.fundamentalOnly = true;
+        }
+        else if (arg == "-p" && hasValue)
+        {
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start <= list.size())
+            {
+                size_t comma = list.find(',', start);
+                std::string item = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+                int col = 0;
+                if (!parseInt(item.c_str(), col))
+                    return false;
+                options.placement.push_back(col);
+                if (comma == std::string::npos)
+                    break;
+                start = comma + 1;
+            }
+        }
+        else if (arg == "-c" && hasValue)
+        {
+            if (!parseInt(argv[++i], options.samples) || options.samples < 0)
+                return false;
+        }
+        else if (arg == "-g" && hasValue)
+        {
+            if (!parseInt(argv[++i], options.given) || options.given < 0)
+                return false;
+        }
+        else if (arg == "-b" && hasValue)
+        {
+            if (!parseInt(argv[++i], options.blocked) || options.blocked < 0)
+                return false;
+        }
+        else if (arg == "-j" && hasValue)
+        {
+            options.journalPath = argv[++i];
+        }
+        else if (arg == "-x" && hasValue)
+        {
+            options.indexPath = argv[++i];
+        }
+        else if (arg == "-k" && hasValue)
+        {
+            options.index = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (options.mode == "local" || options.mode == "construct" || options.mode == "auto")
+    {
+        return options.n >= 1;
+    }
+    if (options.mode == "lookup")
+    {
+        return !options.archivePath.empty();
+    }
+    if (options.mode == "trace")
+    {
+        if (!options.sizeGiven)
+            options.n = 12;
+        return !options.archivePath.empty() && options.n >= 1 && options.n <= MAX_BOARD_SIZE;
+    }
+    if (options.mode == "cube")
+    {
+        return options.n >= 1 && options.n <= MAX_CUBE_SIZE;
+    }
+    if (options.mode == "rank" || options.mode == "unrank" || options.mode == "sample" || options.mode == "puzzles")
+    {
+        if (!options.depthGiven)
+            options.prefixDepth = 4;
+        if (options.mode == "rank")
+        {
+            if (!options.sizeGiven)
+                options.n = static_cast<int>(options.placement.size());
+            if (static_cast<int>(options.placement.size()) != options.n)
+                return false;
+        }
+        return options.n >= 1 && options.n <= MAX_BOARD_SIZE;
+    }
+    if (options.mode == "engines")
+    {
+        if (!options.sizeGiven)
+            options.n = 17;
+        return options.n >= 12 && options.n <= MAX_BOARD_SIZE;
+    }
+    if (options.mode == "farm" && !options.depthGiven)
+    {
+        options.prefixDepth = 3;
+    }
+    if (options.mode == "complete")
+    {
+        if (!options.sizeGiven)
+            options.n = 32;
+        if (options.given < 0)
+            options.given = options.n / 4;
+        if (options.blocked < 0)
+            options.blocked = options.n * options.n / 8;
+        return options.n >= 4 && options.n <= MAX_BOARD_SIZE;
+    }
+    if (options.mode == "fixed")
+    {
+        if (!options.sizeGiven)
+            options.n = 15;
+        return options.n >= FIXED_MIN_SIZE && options.n <= FIXED_MAX_SIZE;
+    }
+    if (options.n < 1 || options.n > MAX_BOARD_SIZE)
+    {
+        return false;
+    }
+    if (!boardVariant(options).isClassic())
+    {
+        return boardVariant(options).valid() && (options.mode == "first" || options.mode == "count");
+    }
+    return options.mode == "first" || options.mode == "count" || options.mode == "enumerate" || options.mode == "farm";
+}
+
+// Writes placements in the selected format (columns are 0-based)
+class SolutionPrinter
+{
+public:
+    explicit SolutionPrinter(const Options &options)
+        : options(options), writer(std::cout, options.format == FORMAT_TEXT ? ' ' : ','), firstEntry(true)
+    {
+        if (options.format == FORMAT_JSON)
+            writer.text("{\n  \"placements\": [");
+    }
+
+    void print(const int *placement)
+    {
+        begin();
+        for (int row = 0; row < options.n; row++)
+        {
+            value(placement[row]);
+        }
+        end();
+    }
+
+    // Streaming form of print(): begin(), one value() per row, end()
+    void begin()
+    {
+        if (options.format == FORMAT_JSON)
+            writer.text(firstEntry ? "\n    [" : ",\n    [");
+        firstEntry = false;
+    }
+
+    void value(int col)
+    {
+        writer.write(col);
+    }
+
+    void end()
+    {
+        if (options.format == FORMAT_JSON)
+            writer.text("]");
+        else
+            writer.endLine();
+    }
+
+    // Closes the placement list; the report follows on std::cout
+    void finish()
+    {
+        if (options.format == FORMAT_JSON)
+            writer.text(firstEntry ? "],\n" : "\n  ],\n");
+        writer.flush();
+    }
+
+private:
+    const Options &options;
+    PlacementWriter writer;
+    bool firstEntry;
+};
+
+// Counter block of -S: one line per counter, then a bar per depth
+static void printStats(const SolverStats &stats)
+{
+    if (!STATS_ENABLED)
+    {
+        std::cout << "stats:          compiled out (built with NQUEENS_NO_STATS)\n";
+        return;
+    }
+    std::cout << "checks:         " << stats.checks << "\n"
+              << "prunes:         " << stats.prunes << "\n"
+              << "search ms:      " << std::setprecision(3) << stats.nanoseconds / 1e6 << "\n"
+              << "nodes by depth:\n";
+    uint64_t widest = 1;
+    for (int depth = 0; depth <= stats.deepest(); depth++)
+        widest = std::max(widest, stats.depthNodes[depth]);
+    for (int depth = 0; depth <= stats.deepest(); depth++)
+    {
+        std::cout << std::setw(6) << depth << std::setw(15) << stats.depthNodes[depth] << "  "
+                  << std::string(static_cast<size_t>(40 * stats.depthNodes[depth] / widest), '#') << "\n";
+    }
+}
+
+static void printReport(const Options &options, const RunReport &report)
+{
+    double nodesPerSecond = report.seconds > 0.0 ? report.nodes / report.seconds : 0.0;
+    uint64_t known = 0;
+    bool counted = options.mode == "count" || options.mode == "enumerate" || options.mode == "farm";
+    const char *verified = "unknown";
+    if (counted && knownVariantCount(boardVariant(options), known))
+    {
+        verified = report.solutions == known ? "yes" : "no";
+    }
+    else if (!counted && report.placementCheck >= 0)
+    {
+        verified = report.placementCheck ? "yes" : "no";
+    }
+
+    std::cout << std::fixed;
+    if (options.format == FORMAT_TEXT)
+    {
+        std::cout << "n:              " << options.n << "\n";
+        if (!boardVariant(options).isClassic())
+            std::cout << "variant:        " << describeVariant(boardVariant(options)) << "\n";
+        std::cout << "mode:           " << options.mode << "\n"
+                  << "threads:        " << report.threads << "\n";
+        if (!options.archivePath.empty())
+            std::cout << "archive:        " << options.archivePath << " (" << report.archived << " records)\n";
+        if (report.frontier > 0)
+            std::cout << "index:          " << report.frontier << " prefixes of " << options.prefixDepth
+                      << " rows, built in " << std::setprecision(3) << report.indexSeconds * 1000.0 << " ms\n";
+        if (report.rank >= 0)
+            std::cout << "rank:           " << report.rank << "\n";
+        if (options.mode == "farm")
+            std::cout << "jobs:           " << report.jobs << " (" << report.resumed << " from the journal)\n";
+        if (options.mode == "puzzles")
+            std::cout << "grades:         " << report.grades[GRADE_EASY] << " easy, " << report.grades[GRADE_MEDIUM]
+                      << " medium, " << report.grades[GRADE_HARD] << " hard\n"
+                      << "puzzles/sec:    " << std::setprecision(0)
+                      << (report.seconds > 0.0 ? report.solutions / report.seconds : 0.0) << "\n";
+        if (counted)
+        {
+            std::cout << "solutions:      " << report.solutions << "\n";
+            if (options.mode == "enumerate")
+                std::cout << "fundamental:    " << report.fundamental << "\n";
+            std::cout << "verified:       " << verified << "\n";
+        }
+        else
+        {
+            std::cout << "found:          " << (report.found ? "yes" : "no") << "\n";
+            if (options.mode == "local")
+                std::cout << "restarts:       " << report.restarts << "\n";
+            if (report.strategy)
+                std::cout << "strategy:       " << report.strategy << "\n";
+            std::cout << "verified:       " << verified << "\n";
+        }
+        std::cout << "nodes:          " << report.nodes << "\n"
+                  << "wall time (ms): " << std::setprecision(3) << report.seconds * 1000.0 << "\n"
+                  << "nodes/sec:      " << std::setprecision(0) << nodesPerSecond << std::endl;
+        if (options.stats)
+        {
+            printStats(report.stats);
+            std::cout.flush();
+        }
+    }
+    else if (options.format == FORMAT_CSV)
+    {
+        std::cout << "n,mode,threads,found,solutions,fundamental,verified,nodes,wall_ms,nodes_per_sec\n"
+                  << options.n << ',' << options.mode << ',' << report.threads << ','
+                  << (report.found ? 1 : 0) << ',' << report.solutions << ',' << report.fundamental << ','
+                  << verified << ',' << report.nodes << ',' << std::setprecision(3) << report.seconds * 1000.0 << ','
+                  << std::setprecision(0) << nodesPerSecond << std::endl;
+    }
+    else
+    {
+        std::cout << "  \"n\": " << options.n << ",\n";
+        if (!boardVariant(options).isClassic())
+            std::cout << "  \"variant\": \"" << describeVariant(boardVariant(options)) << "\",\n";
+        std::cout << "  \"mode\": \"" << options.mode << "\",\n"
+                  << "  \"threads\": " << report.threads << ",\n"
+                  << "  \"archived\": " << report.archived << ",\n"
+                  << "  \"rank\": " << report.rank << ",\n"
+                  << "  \"found\": " << (report.found ? "true" : "false") << ",\n"
+                  << "  \"solutions\": " << report.solutions << ",\n"
+                  << "  \"fundamental\": " << report.fundamental << ",\n"
+                  << "  \"verified\": \"" << verified << "\",\n"
+                  << "  \"nodes\": " << report.nodes << ",\n"
+                  << "  \"wall_ms\": " << std::setprecision(3) << report.seconds * 1000.0 << ",\n"
+                  << "  \"nodes_per_sec\": " << std::setprecision(0) << nodesPerSecond;
+        if (options.stats)
+        {
+            const SolverStats &stats = report.stats;
+            std::cout << ",\n  \"stats\": {\"checks\": " << stats.checks << ", \"prunes\": " << stats.prunes
+                      << ", \"solutions\": " << stats.solutions << ", \"search_ns\": " << stats.nanoseconds
+                      << ", \"depth_nodes\": [";
+            for (int depth = 0; depth <= stats.deepest(); depth++)
+                std::cout << (depth ? ", " : "") << stats.depthNodes[depth];
+            std::cout << "]}";
+        }
+        std::cout << "\n}" << std::endl;
+    }
+}
+
+// Counts N = 12..n with each engine on the same thread pool and compares
+// nodes/sec. Both engines place the same queens, so the node counts match.
+static int runEngineBenchmark(const Options &options)
+{
+    const CountEngine engines[] = {ENGINE_SCALAR, ENGINE_AVX2};
+    bool haveAvx2 = avx2Available();
+    if (!haveAvx2)
+        std::cerr << "AVX2 not supported on this CPU; the avx2 rows fall back to scalar" << std::endl;
+
+    std::cout << std::fixed;
+    if (options.format == FORMAT_CSV)
+        std::cout << "n,engine,threads,solutions,verified,nodes,wall_ms,nodes_per_sec,speedup\n";
+    else if (options.format == FORMAT_JSON)
+        std::cout << "[";
+    else
+        std::cout << " n  engine   solutions          nodes      wall ms      nodes/sec  speedup\n";
+
+    bool first = true;
+    for (int n = 12; n <= options.n; n++)
+    {
+        double scalarRate = 0.0;
+        for (CountEngine engine : engines)
+        {
+            auto start = std::chrono::steady_clock::now();
+            ParallelCountResult result = countSolutionsParallel(n, options.prefixDepth, options.threads, engine);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double rate = seconds > 0.0 ? result.nodes / seconds : 0.0;
+            if (engine == ENGINE_SCALAR)
+                scalarRate = rate;
+            double speedup = scalarRate > 0.0 ? rate / scalarRate : 0.0;
+            uint64_t known = 0;
+            const char *verified = knownSolutionCount(n, known) ? (known == result.solutions ? "yes" : "no") : "unknown";
+            const char *name = engineName(resolveEngine(engine));
+
+            if (options.format == FORMAT_CSV)
+            {
+                std::cout << n << ',' << name << ',' << result.threads << ',' << result.solutions << ','
+                          << verified << ',' << result.nodes << ',' << std::setprecision(3) << seconds * 1000.0 << ','
+                          << std::setprecision(0) << rate << ',' << std::setprecision(2) << speedup << "\n";
+            }
+            else if (options.format == FORMAT_JSON)
+            {
+                std::cout << (first ? "\n" : ",\n") << "  {\"n\": " << n << ", \"engine\": \"" << name
+                          << "\", \"threads\": " << result.threads << ", \"solutions\": " << result.solutions
+                          << ", \"verified\": \"" << verified << "\", \"nodes\": " << result.nodes
+                          << ", \"wall_ms\": " << std::setprecision(3) << seconds * 1000.0
+                          << ", \"nodes_per_sec\": " << std::setprecision(0) << rate
+                          << ", \"speedup\": " << std::setprecision(2) << speedup << "}";
+            }
+            else
+            {
+                std::cout << std::setw(2) << n << "  " << std::left << std::setw(6) << name << std::right
+                          << std::setw(12) << result.solutions << std::setw(15) << result.nodes
+                          << std::setprecision(1) << std::setw(13) << seconds * 1000.0
+                          << std::setprecision(0) << std::setw(15) << rate
+                          << std::setprecision(2) << std::setw(8) << speedup << "x"
+                          << (verified[0] == 'n' ? "  WRONG COUNT" : "") << "\n";
+            }
+            std::cout.flush();
+            first = false;
+        }
+    }
+    if (options.format == FORMAT_JSON)
+        std::cout << "\n]" << std::endl;
+    return 0;
+}
+
+// Single-threaded count of N = 4..n with the runtime-N search and with the
+// compiled Solver<N>, plus the time to the first solution for each
+static int runFixedBenchmark(const Options &options)
+{
+    std::cout << std::fixed;
+    if (options.format == FORMAT_CSV)
+        std::cout << "n,solutions,nodes,generic_ms,fixed_ms,speedup,first_generic_ms,first_fixed_ms,first_speedup\n";
+    else if (options.format == FORMAT_JSON)
+        std::cout << "[";
+    else
+        std::cout << " n   solutions          nodes   generic ms     fixed ms  speedup   first speedup\n";
+
+    for (int n = FIXED_MIN_SIZE; n <= options.n; n++)
+    {
+        uint64_t genericNodes = 0;
+        uint64_t fixedNodes = 0;
+        auto start = std::chrono::steady_clock::now();
+        uint64_t solutions = countSolutions(n, &genericNodes);
+        auto middle = std::chrono::steady_clock::now();
+        uint64_t fixedSolutions = fixedCounter(n)(fixedNodes);
+        auto end = std::chrono::steady_clock::now();
+        double genericSeconds = std::chrono::duration<double>(middle - start).count();
+        double fixedSeconds = std::chrono::duration<double>(end - middle).count();
+
+        int placement[MAX_BOARD_SIZE];
+        uint64_t ignored = 0;
+        start = std::chrono::steady_clock::now();
+        solveQueens(n, placement, &ignored);
+        middle = std::chrono::steady_clock::now();
+        fixedFirstSolver(n)(placement, ignored);
+        end = std::chrono::steady_clock::now();
+        double firstGeneric = std::chrono::duration<double>(middle - start).count();
+        double firstFixed = std::chrono::duration<double>(end - middle).count();
+
+        if (solutions != fixedSolutions || genericNodes != fixedNodes)
+        {
+            std::cerr << "n = " << n << ": Solver<N> disagrees with the runtime-N search" << std::endl;
+            return 1;
+        }
+
+        double speedup = fixedSeconds > 0.0 ? genericSeconds / fixedSeconds : 0.0;
+        double firstSpeedup = firstFixed > 0.0 ? firstGeneric / firstFixed : 0.0;
+        if (options.format == FORMAT_CSV)
+        {
+            std::cout << n << ',' << solutions << ',' << genericNodes << ',' << std::setprecision(3)
+                      << genericSeconds * 1000.0 << ',' << fixedSeconds * 1000.0 << ',' << std::setprecision(2)
+                      << speedup << ',' << std::setprecision(3) << firstGeneric * 1000.0 << ','
+                      << firstFixed * 1000.0 << ',' << std::setprecision(2) << firstSpeedup << "\n";
+        }
+        else if (options.format == FORMAT_JSON)
+        {
+            std::cout << (n == FIXED_MIN_SIZE ? "\n" : ",\n") << "  {\"n\": " << n << ", \"solutions\": " << solutions
+                      << ", \"nodes\": " << genericNodes << ", \"generic_ms\": " << std::setprecision(3)
+                      << genericSeconds * 1000.0 << ", \"fixed_ms\": " << fixedSeconds * 1000.0
+                      << ", \"speedup\": " << std::setprecision(2) << speedup
+                      << ", \"first_speedup\": " << firstSpeedup << "}";
+        }
+        else
+        {
+            std::cout << std::setw(2) << n << std::setw(12) << solutions << std::setw(15) << genericNodes
+                      << std::setprecision(3) << std::setw(13) << genericSeconds * 1000.0 << std::setw(13)
+                      << fixedSeconds * 1000.0 << std::setprecision(2) << std::setw(8) << speedup << "x"
+                      << std::setw(15) << firstSpeedup << "x\n";
+        }
+        std::cout.flush();
+    }
+    if (options.format == FORMAT_JSON)
+        std::cout << "\n]" << std::endl;
+    return 0;
+}
+
+// Completes random constrained boards (pre-placed queens plus blocked squares,
+// always solvable) with the row-order search, with forward checking in row and
+// MRV order, and with dancing links under each item chooser. Node counts are
+// queens placed, so every solver is measured against the row-order search.
+// The backtracking searches give up after ROW_ORDER_LIMIT nodes.
+static const uint64_t ROW_ORDER_LIMIT = 200000000ULL;
+
+static int runCompletionBenchmark(const Options &options)
+{
+    enum Engine
+    {
+        ROW_ORDER,
+        FORWARD_CHECKING,
+        DANCING_LINKS
+    };
+    struct Contender
+    {
+        const char *name;
+        Engine engine;
+        BranchOrder order;   // forward checking
+        ItemChooser chooser; // dancing links
+    };
+    const Contender contenders[] = {{"row-order", ROW_ORDER, BRANCH_ROWS, nullptr},
+                                    {"fc-rows", FORWARD_CHECKING, BRANCH_ROWS, nullptr},
+                                    {"fc-mrv", FORWARD_CHECKING, BRANCH_MRV, nullptr},
+                                    {"dlx-first", DANCING_LINKS, BRANCH_ROWS, chooseFirstItem},
+                                    {"dlx-mrv", DANCING_LINKS, BRANCH_ROWS, chooseMinimumRemaining}};
+    const int contenderCount = 5;
+
+    std::cout << std::fixed;
+    if (options.format == FORMAT_CSV)
+        std::cout << "instance,n,given,blocked,solver,found,verified,nodes,wall_ms\n";
+    else if (options.format == FORMAT_JSON)
+        std::cout << "[";
+    else
+        std::cout << "  #   n  given  blocked  solver      found  verified          nodes      wall ms\n";
+
+    uint64_t totalNodes[contenderCount] = {};
+    double totalSeconds[contenderCount] = {};
+    int solved[contenderCount] = {};
+    SolverStats totalStats[contenderCount];
+    DancingLinks links;
+    PropagationSolver propagation;
+    std::vector<int> placement(options.n);
+    bool first = true;
+    for (int instance = 0; instance < std::max(1, options.samples); instance++)
+    {
+        BoardConstraints constraints = randomConstraints(options.n, options.given, options.blocked, options.seed + instance);
+        for (int c = 0; c < contenderCount; c++)
+        {
+            uint64_t nodes = 0;
+            auto start = std::chrono::steady_clock::now();
+            bool found;
+            if (contenders[c].engine == DANCING_LINKS)
+            {
+                links.setChooser(contenders[c].chooser);
+                found = links.solve(constraints, placement.data(), &nodes);
+                totalStats[c].merge(links.stats());
+            }
+            else if (contenders[c].engine == FORWARD_CHECKING)
+            {
+                propagation.setOrder(contenders[c].order);
+                found = propagation.solve(constraints, placement.data(), &nodes, ROW_ORDER_LIMIT);
+                totalStats[c].merge(propagation.stats());
+            }
+            else
+            {
+                found = solveInRowOrder(constraints, placement.data(), &nodes, ROW_ORDER_LIMIT, &totalStats[c]);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const char *verified = found ? (satisfiesConstraints(constraints, placement.data()) ? "yes" : "no") : "-";
+            totalNodes[c] += nodes;
+            totalSeconds[c] += seconds;
+            solved[c] += found ? 1 : 0;
+
+            if (options.format == FORMAT_CSV)
+            {
+                std::cout << instance << ',' << options.n << ',' << constraints.queens.size() << ','
+                          << constraints.blocked.size() << ',' << contenders[c].name << ',' << (found ? 1 : 0) << ','
+                          << verified << ',' << nodes << ',' << std::setprecision(3) << seconds * 1000.0 << "\n";
+            }
+            else if (options.format == FORMAT_JSON)
+            {
+                std::cout << (first ? "\n" : ",\n") << "  {\"instance\": " << instance << ", \"n\": " << options.n
+                          << ", \"given\": " << constraints.queens.size() << ", \"blocked\": " << constraints.blocked.size()
+                          << ", \"solver\": \"" << contenders[c].name << "\", \"found\": " << (found ? "true" : "false")
+                          << ", \"verified\": \"" << verified << "\", \"nodes\": " << nodes
+                          << ", \"wall_ms\": " << std::setprecision(3) << seconds * 1000.0 << "}";
+            }
+            else
+            {
+                std::cout << std::setw(3) << instance << std::setw(4) << options.n << std::setw(7) << constraints.queens.size()
+                          << std::setw(9) << constraints.blocked.size() << "  " << std::left << std::setw(10)
+                          << contenders[c].name << std::right << std::setw(7) << (found ? "yes" : "no")
+                          << std::setw(10) << verified << std::setw(15) << nodes << std::setprecision(3)
+                          << std::setw(13) << seconds * 1000.0
+                          << (!found && nodes >= ROW_ORDER_LIMIT ? "  gave up" : "") << "\n";
+            }
+            std::cout.flush();
+            first = false;
+        }
+    }
+
+    if (options.format == FORMAT_JSON)
+        std::cout << "\n]" << std::endl;
+    else if (options.format == FORMAT_TEXT)
+    {
+        std::cout << "\ntotals\n";
+        for (int c = 0; c < contenderCount; c++)
+        {
+            std::cout << "  " << std::left << std::setw(10) << contenders[c].name << std::right << std::setw(5)
+                      << solved[c] << " solved" << std::setw(15) << totalNodes[c] << " nodes"
+                      << std::setprecision(3) << std::setw(13) << totalSeconds[c] * 1000.0 << " ms\n";
+            if (options.stats)
+                std::cout << "             " << statsSummary(totalStats[c]) << "\n";
+        }
+        std::cout.flush();
+    }
+    return 0;
+}
+
+static const int TRACE_SEEK_SAMPLES = 2000;
+
+// Records a trace (unless -i names one), then checks it: a full replay where
+// every event must be legal, seeks to random positions compared with the
+// board the replay reached there, and seeks to random solutions
+static int runTraceMode(const Options &options)
+{
+    std::cout << std::fixed;
+    const std::string &path = options.archivePath;
+    if (!options.inputGiven)
+    {
+        auto start = std::chrono::steady_clock::now();
+        TraceRecording recording = recordSearchTrace(path, options.n, true, options.eventLimit);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!recording.ok)
+        {
+            std::cerr << recording.error << std::endl;
+            return 1;
+        }
+        std::cout << "recorded:       " << recording.events << " events, " << recording.solutions << " solutions"
+                  << (recording.complete ? "" : " (cut short)") << " in " << std::setprecision(3)
+                  << seconds * 1000.0 << " ms\n";
+    }
+
+    SearchTrace trace;
+    if (!trace.open(path))
+    {
+        std::cerr << trace.error() << std::endl;
+        return 1;
+    }
+    int n = trace.boardSize();
+    std::cout << "trace:          " << path << " (n = " << n << ", " << trace.size() << " events, "
+              << trace.keyframes() << " keyframes every " << trace.keyframeInterval() << ")\n";
+
+    // Full replay with an independent legality check of every event
+    auto start = std::chrono::steady_clock::now();
+    std::vector<char> cols(n, 0), diagonals(2 * n, 0), antiDiagonals(2 * n, 0);
+    std::vector<int> placement(n);
+    int depth = 0;
+    uint64_t solutions = 0;
+    uint64_t bad = trace.size();
+    for (uint64_t k = 0; k < trace.size() && bad == trace.size(); k++)
+    {
+        TraceEvent event = trace.event(k);
+        int row = event.row;
+        int col = event.col;
+        if (event.removed)
+        {
+            if (row != depth - 1 || placement[row] != col)
+            {
+                bad = k;
+                break;
+            }
+            cols[col] = diagonals[row + col] = antiDiagonals[row - col + n - 1] = 0;
+            depth--;
+        }
+        else
+        {
+            if (row != depth || col >= n || cols[col] || diagonals[row + col] || antiDiagonals[row - col + n - 1])
+            {
+                bad = k;
+                break;
+            }
+            cols[col] = diagonals[row + col] = antiDiagonals[row - col + n - 1] = 1;
+            placement[row] = col;
+            if (++depth == n)
+                solutions++;
+        }
+    }
+    double replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t known = 0;
+    const char *verified = "unknown";
+    if (bad < trace.size() || solutions != trace.solutions())
+        verified = "no";
+    else if (trace.complete() && trace.allSolutions() && knownSolutionCount(n, known))
+        verified = solutions == known ? "yes" : "no";
+    if (bad < trace.size())
+        std::cout << "illegal event:  #" << bad << "\n";
+    std::cout << "solutions:      " << solutions << (trace.complete() ? "" : " (trace cut short)") << "\n"
+              << "replay (ms):    " << std::setprecision(3) << replaySeconds * 1000.0 << " ("
+              << std::setprecision(0) << (replaySeconds > 0.0 ? trace.size() / replaySeconds : 0.0)
+              << " events/sec)\n";
+
+    // Random seeks, checked against a cursor that walks forward to the same
+    // positions in order
+    std::mt19937_64 random(options.seed);
+    std::vector<uint64_t> positions(TRACE_SEEK_SAMPLES);
+    for (uint64_t &position : positions)
+        position = std::uniform_int_distribution<uint64_t>(0, trace.size())(random);
+    std::sort(positions.begin(), positions.end());
+    TraceCursor walker(trace);
+    TraceCursor seeker(trace);
+    int mismatches = 0;
+    double seekSeconds = 0.0;
+    for (uint64_t position : positions)
+    {
+        walker.advance(position - walker.position());
+        auto seekStart = std::chrono::steady_clock::now();
+        seeker.seek(position);
+        seekSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - seekStart).count();
+        if (seeker.depth() != walker.depth() || seeker.solutions() != walker.solutions() ||
+            !std::equal(seeker.placement(), seeker.placement() + seeker.depth(), walker.placement()))
+            mismatches++;
+    }
+    std::cout << "seeks:          " << TRACE_SEEK_SAMPLES << " random, " << mismatches << " mismatched, "
+              << std::setprecision(2) << seekSeconds * 1e6 / TRACE_SEEK_SAMPLES << " us each\n";
+
+    // Every keyframe position, where a seek uses the stored board as is
+    walker.rewind();
+    int keyframeMismatches = 0;
+    for (uint64_t k = 0; k < trace.keyframes(); k++)
+    {
+        uint64_t position = std::min(k * trace.keyframeInterval(), trace.size());
+        walker.advance(position - walker.position());
+        seeker.seek(position);
+        if (seeker.depth() != walker.depth() || seeker.solutions() != walker.solutions() ||
+            !std::equal(seeker.placement(), seeker.placement() + seeker.depth(), walker.placement()))
+            keyframeMismatches++;
+    }
+    std::cout << "keyframe seeks: " << trace.keyframes() << ", " << keyframeMismatches << " mismatched\n";
+    mismatches += keyframeMismatches;
+
+    if (trace.solutions() > 0)
+    {
+        int wrong = 0;
+        seekSeconds = 0.0;
+        for (int i = 0; i < TRACE_SEEK_SAMPLES; i++)
+        {
+            uint64_t k = std::uniform_int_distribution<uint64_t>(0, trace.solutions() - 1)(random);
+            auto seekStart = std::chrono::steady_clock::now();
+            bool found = seeker.seekSolution(k);
+            seekSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - seekStart).count();
+            if (!found || seeker.depth() != n || seeker.solutions() != k + 1 ||
+                !verifyPlacement(n, seeker.placement()))
+                wrong++;
+        }
+        std::cout << "solution seeks: " << TRACE_SEEK_SAMPLES << " random, " << wrong << " wrong, "
+                  << std::setprecision(2) << seekSeconds * 1e6 / TRACE_SEEK_SAMPLES << " us each\n";
+        mismatches += wrong;
+    }
+    if (mismatches > 0)
+        verified = "no";
+    std::cout << "verified:       " << verified << "\n";
+    std::cout.flush();
+    return std::string(verified) != "no" ? 0 : 1;
+}
+
+// Solves one cube and checks the queens with the pairwise verifier
+static int runCubeMode(const Options &options)
+{
+    CubeSolveOptions cube;
+    cube.n = options.n;
+    cube.target = options.given;
+    cube.threads = options.threads;
+    cube.prefixDepth = options.prefixDepth;
+    cube.seed = options.seed;
+    if (options.eventLimit > 0)
+        cube.nodeLimit = options.eventLimit;
+
+    auto start = std::chrono::steady_clock::now();
+    CubeSolveResult result = solveCube(cube);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    bool verified = !result.found || verifyCube(options.n, result.queens);
+
+    int known = 0;
+    bool maximum = knownCubeMaximum(options.n, known) && known == result.target;
+    std::cout << std::fixed;
+    std::cout << "cube:           " << options.n << " x " << options.n << " x " << options.n << ", " << result.target
+              << " queens" << (maximum ? " (the most that fit)" : "") << "\n";
+    if (result.found)
+        std::cout << "found:          yes, by the " << (result.byWalk ? "local-search walks" : "exact search")
+                  << " in round " << result.rounds << "\n";
+    else
+        std::cout << "found:          " << (result.exhausted ? "no, none exists" : "no, node limit reached") << "\n";
+    std::cout << "verified:       " << (result.found ? (verified ? "yes" : "no") : "-") << "\n"
+              << "nodes:          " << result.nodes << "\n"
+              << "threads:        " << result.threads << " (" << result.tasks << " exact-search tasks a round)\n"
+              << "time (ms):      " << std::setprecision(3) << seconds * 1000.0 << "\n";
+
+    if (result.found && !options.quiet)
+    {
+        std::vector<std::string> layers(options.n, std::string(options.n * options.n, '.'));
+        for (const CubeQueen &queen : result.queens)
+            layers[queen.layer][queen.row * options.n + queen.col] = 'Q';
+        for (int layer = 0; layer < options.n; layer++)
+        {
+            std::cout << "\nlayer " << layer << ":\n";
+            for (int row = 0; row < options.n; row++)
+            {
+                for (int col = 0; col < options.n; col++)
+                    std::cout << (col ? " " : "") << layers[layer][row * options.n + col];
+                std::cout << "\n";
+            }
+        }
+    }
+    std::cout.flush();
+    return result.found && verified ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    if (options.mode == "engines")
+    {
+        return runEngineBenchmark(options);
+    }
+    if (options.mode == "fixed")
+    {
+        return runFixedBenchmark(options);
+    }
+    if (options.mode == "complete")
+    {
+        return runCompletionBenchmark(options);
+    }
+    if (options.mode == "trace")
+    {
+        return runTraceMode(options);
+    }
+    if (options.mode == "cube")
+    {
+        return runCubeMode(options);
+    }
+
+    RunReport report;
+    SolutionPrinter printer(options);
+    auto start = std::chrono::steady_clock::now();
+
+    if (options.mode == "first" && !boardVariant(options).isClassic())
+    {
+        // Attack-table search; the pieces are checked against the variant's own moves
+        int placement[MAX_BOARD_SIZE];
+        report.found = solveVariant(boardVariant(options), placement, &report.nodes, options.stats ? &report.stats : nullptr);
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.solutions = report.found ? 1 : 0;
+        if (report.found)
+        {
+            report.placementCheck = verifyVariantPlacement(boardVariant(options), placement);
+            if (!options.quiet)
+                printer.print(placement);
+        }
+    }
+    else if (options.mode == "first")
+    {
+        int placement[MAX_BOARD_SIZE];
+        FixedFirstFunction fixedFirst = fixedFirstSolver(options.n);
+        // Compiled Solver<N> where one exists (same search, same nodes); -S
+        // runs the instrumented runtime-N search instead
+        if (options.stats)
+            report.found = solveQueens(options.n, placement, &report.nodes, threadArena(), &report.stats);
+        else
+            report.found = fixedFirst ? fixedFirst(placement, report.nodes) : solveQueens(options.n, placement, &report.nodes);
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.solutions = report.found ? 1 : 0;
+        if (report.found)
+        {
+            report.placementCheck = verifyPlacement(options.n, placement);
+            if (!options.quiet)
+                printer.print(placement);
+        }
+    }
+    else if (options.mode == "farm")
+    {
+        // Jobs are printed as they finish (-q hides them); the worker table
+        // shows each process's share and rate
+        FarmOptions farmOptions;
+        farmOptions.n = options.n;
+        farmOptions.prefixDepth = options.prefixDepth;
+        farmOptions.workers = options.threads;
+        farmOptions.journalPath = options.journalPath;
+        farmOptions.engine = options.engine;
+        bool showJobs = !options.quiet && options.format == FORMAT_TEXT;
+        if (showJobs)
+            std::cout << "   job     solutions          nodes      wall ms  worker\n";
+        FarmResult result = runSolverFarm(farmOptions, [&](const FarmJob &job)
+                                          {
+                                              if (!showJobs)
+                                                  return;
+                                              std::cout << std::setw(6) << job.job << std::setw(14) << job.solutions
+                                                        << std::setw(15) << job.nodes << std::fixed << std::setprecision(3)
+                                                        << std::setw(13) << job.nanoseconds / 1e6 << std::setw(8);
+                                              if (job.worker < 0)
+                                                  std::cout << "journal";
+                                              else
+                                                  std::cout << job.worker;
+                                              std::cout << "\n"; });
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!result.ok)
+        {
+            std::cerr << result.error << std::endl;
+            return 1;
+        }
+        report.solutions = result.solutions;
+        report.nodes = result.nodes;
+        report.found = result.solutions > 0;
+        report.threads = static_cast<int>(result.workers.size());
+        report.jobs = result.jobCount;
+        report.resumed = result.resumed;
+        if (options.format == FORMAT_TEXT)
+        {
+            std::cout << "\nworker      pid   jobs          nodes      busy ms      nodes/sec\n";
+            for (size_t w = 0; w < result.workers.size(); w++)
+            {
+                const FarmWorker &worker = result.workers[w];
+                double busy = worker.nanoseconds / 1e9;
+                std::cout << std::setw(6) << w << std::setw(9) << worker.pid << std::setw(7) << worker.jobs
+                          << std::setw(15) << worker.nodes << std::fixed << std::setprecision(1) << std::setw(13)
+                          << busy * 1000.0 << std::setprecision(0) << std::setw(15)
+                          << (busy > 0.0 ? worker.nodes / busy : 0.0) << (worker.lost ? "  lost" : "") << "\n";
+            }
+            std::cout << "\n";
+        }
+    }
+    else if (options.mode == "count")
+    {
+        SolverStats *stats = options.stats ? &report.stats : nullptr;
+        ParallelCountResult result = boardVariant(options).isClassic()
+                                         ? countSolutionsParallel(options.n, options.prefixDepth, options.threads, options.engine, stats)
+                                         : countVariantSolutions(boardVariant(options), options.prefixDepth, options.threads, stats);
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.solutions = result.solutions;
+        report.nodes = result.nodes;
+        report.threads = result.threads;
+        report.found = result.solutions > 0;
+    }
+    else if (options.mode == "local")
+    {
+        MinConflictsOptions localOptions;
+        localOptions.seed = options.seed;
+        std::vector<int> placement;
+        MinConflictsResult result = solveMinConflicts(options.n, placement, localOptions);
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.found = result.solved;
+        report.solutions = result.solved ? 1 : 0;
+        report.nodes = result.swapsTried;
+        report.restarts = result.restarts;
+        if (result.solved)
+        {
+            report.placementCheck = verifyPlacement(options.n, placement.data());
+            if (!options.quiet)
+                printer.print(placement.data());
+        }
+    }
+    else if (options.mode == "construct")
+    {
+        // Rows are generated, checked and written one at a time; nothing of
+        // size n is kept apart from the verifier's bitsets
+        report.found = hasConstruction(options.n);
+        if (report.found)
+        {
+            PlacementVerifier verifier(options.n);
+            if (!options.quiet)
+                printer.begin();
+            for (int row = 0; row < options.n; row++)
+            {
+                int col = constructedColumn(options.n, row);
+                verifier.add(col);
+                if (!options.quiet)
+                    printer.value(col);
+            }
+            if (!options.quiet)
+                printer.end();
+            report.placementCheck = verifier.valid();
+            report.nodes = options.n;
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.solutions = report.found ? 1 : 0;
+    }
+    else if (options.mode == "auto")
+    {
+        std::vector<int> placement;
+        SolveResult result = findPlacement(options.n, placement);
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.found = result.found;
+        report.solutions = result.found ? 1 : 0;
+        report.nodes = result.nodes;
+        report.strategy = strategyName(result.strategy);
+        if (result.found)
+        {
+            report.placementCheck = verifyPlacement(options.n, placement.data());
+            if (!options.quiet)
+                printer.print(placement.data());
+        }
+    }
+    else if (options.mode == "lookup")
+    {
+        // The archive is mapped, not read: only solution k's record is touched
+        SolutionArchive archive;
+        if (!archive.open(options.archivePath))
+        {
+            std::cerr << archive.error() << std::endl;
+            return 1;
+        }
+        options.n = archive.boardSize();
+        report.archived = archive.size();
+        report.found = options.index < archive.size();
+        if (report.found)
+        {
+            std::vector<int> placement(options.n);
+            archive.solution(options.index, placement.data());
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            report.solutions = 1;
+            report.placementCheck = verifyPlacement(options.n, placement.data());
+            if (!options.quiet)
+                printer.print(placement.data());
+        }
+        else
+        {
+            std::cerr << "index " << options.index << " is past the last of " << archive.size() << " solutions" << std::endl;
+        }
+    }
+    else if (options.mode == "rank" || options.mode == "unrank" || options.mode == "sample" || options.mode == "puzzles")
+    {
+        // The index build (or load) is timed on its own; the report times the query
+        SolutionIndex index;
+        bool cached = !options.indexPath.empty() && index.load(options.indexPath) &&
+                      index.boardSize() == options.n && index.prefixDepth() == options.prefixDepth;
+        if (!cached)
+        {
+            index.build(options.n, options.prefixDepth, options.threads);
+            if (!options.indexPath.empty() && !index.save(options.indexPath))
+                std::cerr << "cannot save the index to " << options.indexPath << std::endl;
+        }
+        auto built = std::chrono::steady_clock::now();
+        report.indexSeconds = std::chrono::duration<double>(built - start).count();
+        report.frontier = index.frontierSize();
+        report.threads = std::max(1, index.buildThreads());
+
+        if (options.mode == "puzzles")
+        {
+            // One line per puzzle: the clue column of each row, -1 where the
+            // player has to place a queen
+            std::vector<Puzzle> puzzles = generatePuzzles(index, options.samples, options.seed, options.threads);
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - built).count();
+            report.threads = options.threads > 0 ? options.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            bool valid = true;
+            for (const Puzzle &puzzle : puzzles)
+            {
+                report.solutions++;
+                report.nodes += puzzle.nodes;
+                report.grades[puzzle.grade]++;
+                valid = valid && verifyPlacement(options.n, puzzle.solution.data());
+                if (!options.quiet)
+                {
+                    std::vector<int> clues(options.n, -1);
+                    for (const auto &clue : puzzle.clues)
+                        clues[clue.first] = clue.second;
+                    printer.print(clues.data());
+                }
+            }
+            report.found = report.solutions > 0;
+            if (report.found)
+                report.placementCheck = valid;
+        }
+        else if (options.mode == "sample")
+        {
+            // Uniform over all solutions: a random rank, unranked
+            SolutionSampler sampler(index, options.seed);
+            std::vector<int> placement(options.n);
+            bool valid = true;
+            for (int i = 0; i < options.samples && sampler.sample(placement.data(), &report.nodes); i++)
+            {
+                report.solutions++;
+                valid = valid && verifyPlacement(options.n, placement.data());
+                if (!options.quiet)
+                    printer.print(placement.data());
+            }
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - built).count();
+            report.found = report.solutions > 0;
+            if (report.found)
+                report.placementCheck = valid;
+        }
+        else if (options.mode == "unrank")
+        {
+            std::vector<int> placement(options.n);
+            report.found = index.unrank(options.index, placement.data(), &report.nodes);
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - built).count();
+            if (report.found)
+            {
+                report.solutions = 1;
+                report.placementCheck = verifyPlacement(options.n, placement.data());
+                if (!options.quiet)
+                    printer.print(placement.data());
+            }
+            else
+            {
+                std::cerr << "index " << options.index << " is past the last of " << index.total() << " solutions" << std::endl;
+            }
+        }
+        else
+        {
+            uint64_t position = 0;
+            report.found = index.rank(options.placement.data(), position, &report.nodes);
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - built).count();
+            report.placementCheck = report.found;
+            if (report.found)
+            {
+                report.solutions = 1;
+                report.rank = static_cast<int64_t>(position);
+            }
+            else
+            {
+                std::cerr << "not a solution of the " << options.n << "x" << options.n << " board" << std::endl;
+            }
+        }
+    }
+    else if (!options.archivePath.empty())
+    {
+        // Binary archive: the writer buffers records and patches the count at close
+        SolutionArchiveWriter writer(options.archivePath, options.n, options.fundamentalOnly);
+        if (!writer.good())
+        {
+            std::cerr << "cannot create " << options.archivePath << std::endl;
+            return 1;
+        }
+        bool fundamentalOnly = options.fundamentalOnly;
+        int n = options.n;
+        EnumerationResult result = enumerateSolutions(options.n, [&](const int *placement, const int *canonical)
+                                                      {
+                                                          if (!fundamentalOnly || std::equal(placement, placement + n, canonical))
+                                                              writer.add(placement); });
+        if (!writer.close())
+        {
+            std::cerr << "write to " << options.archivePath << " failed" << std::endl;
+            return 1;
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.solutions = result.total;
+        report.fundamental = result.fundamental;
+        report.nodes = result.nodes;
+        report.found = result.total > 0;
+        report.archived = writer.count();
+    }
+    else
+    {
+        // Printing happens inside the search, so use -q to time the search alone
+        EnumerationResult result = enumerateSolutions(options.n, [&](const int *placement, const int *)
+                                                      {
+                                                          if (!options.quiet)
+                                                              printer.print(placement); });
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.solutions = result.total;
+        report.fundamental = result.fundamental;
+        report.nodes = result.nodes;
+        report.found = result.total > 0;
+    }
+
+    printer.finish();
+    printReport(options, report);
+    return 0;
+}
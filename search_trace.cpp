@@ -0,0 +1,332 @@
+#include "search_trace.h"
+#include "stepwise_solver.h"
+
+#include <cstring>
+
+static const char TRACE_MAGIC[8] = {'N', 'Q', 'T', 'R', 'A', 'C', 'E', '1'};
+
+SearchTraceWriter::SearchTraceWriter(const std::string &path, int n, bool allSolutions, uint32_t keyframeInterval)
+    : out(path), n(n), interval(keyframeInterval), flags(allSolutions ? TRACE_ALL_SOLUTIONS : 0), depth(0),
+      written(0), found(0), ok(n >= 1 && n <= MAX_BOARD_SIZE && keyframeInterval > 0 && out.good()),
+      closed(false)
+{
+    // Header goes out now with zero counts; close() patches them
+    uint8_t header[TRACE_HEADER_SIZE] = {};
+    std::memcpy(header, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    storeLittle(header + 8, static_cast<uint64_t>(n), 2);
+    header[10] = flags;
+    storeLittle(header + 12, interval, 4);
+    if (ok)
+    {
+        out.write(header, sizeof(header));
+    }
+}
+
+SearchTraceWriter::~SearchTraceWriter()
+{
+    close();
+}
+
+void SearchTraceWriter::place(int col)
+{
+    if (!ok || depth >= n)
+    {
+        return;
+    }
+    add(static_cast<uint8_t>(depth), static_cast<uint8_t>(col));
+    columns[depth++] = col;
+    if (depth == n)
+    {
+        found++;
+    }
+}
+
+void SearchTraceWriter::remove()
+{
+    if (!ok || depth == 0)
+    {
+        return;
+    }
+    // The event goes in first so that a keyframe it starts still has the queen
+    add(static_cast<uint8_t>((depth - 1) | TRACE_REMOVED), static_cast<uint8_t>(columns[depth - 1]));
+    depth--;
+}
+
+void SearchTraceWriter::add(uint8_t row, uint8_t col)
+{
+    // The board before this event is the keyframe for its position
+    if (written % interval == 0)
+    {
+        keyframe();
+    }
+    uint8_t *event = out.reserve(2);
+    event[0] = row;
+    event[1] = col;
+    written++;
+}
+
+void SearchTraceWriter::keyframe()
+{
+    size_t start = keyframes.size();
+    keyframes.resize(start + 9 + n, 0);
+    storeLittle(&keyframes[start], found, 8);
+    keyframes[start + 8] = static_cast<uint8_t>(depth);
+    for (int row = 0; row < depth; row++)
+    {
+        keyframes[start + 9 + row] = static_cast<uint8_t>(columns[row]);
+    }
+}
+
+bool SearchTraceWriter::close()
+{
+    if (closed)
+    {
+        return good();
+    }
+    closed = true;
+    if (ok && written % interval == 0)
+    {
+        keyframe(); // the board after the last event starts a new interval
+    }
+    if (ok)
+    {
+        out.write(keyframes.data(), keyframes.size());
+        uint8_t counts[16];
+        storeLittle(counts, written, 8);
+        storeLittle(counts + 8, found, 8);
+        out.patch(10, &flags, 1);
+        out.patch(16, counts, sizeof(counts));
+    }
+    ok = out.close() && ok;
+    return ok;
+}
+
+TraceRecording recordSearchTrace(const std::string &path, int n, bool allSolutions, uint64_t maxEvents)
+{
+    TraceRecording recording;
+    if (n < 1 || n > MAX_BOARD_SIZE)
+    {
+        recording.error = "board size must be 1.." + std::to_string(MAX_BOARD_SIZE);
+        return recording;
+    }
+    SearchTraceWriter writer(path, n, allSolutions);
+    if (!writer.good())
+    {
+        recording.error = "cannot create " + path;
+        return recording;
+    }
+
+    StepwiseSolver solver(n);
+    solver.reset(n, allSolutions);
+    while (!solver.finished() && (maxEvents == 0 || writer.events() < maxEvents))
+    {
+        SolveEvent event = solver.step();
+        if (event == SOLVE_PLACED || event == SOLVE_SOLVED)
+            writer.place(solver.lastCol());
+        else if (event == SOLVE_REMOVED)
+            writer.remove();
+    }
+    recording.complete = solver.finished();
+    if (recording.complete)
+    {
+        writer.markComplete();
+    }
+    recording.events = writer.events();
+    recording.solutions = writer.solutions();
+    recording.ok = writer.close();
+    if (!recording.ok)
+    {
+        recording.error = "write to " + path + " failed";
+    }
+    return recording;
+}
+
+SearchTrace::SearchTrace()
+    : data(nullptr), keyframeTable(nullptr), n(0), flags(0), interval(0), count(0), solutionCount(0)
+{
+}
+
+SearchTrace::~SearchTrace()
+{
+    close();
+}
+
+bool SearchTrace::open(const std::string &path)
+{
+    close();
+
+    if (!file.open(path))
+    {
+        message = file.error();
+        return false;
+    }
+    data = file.data();
+    if (file.size() < static_cast<size_t>(TRACE_HEADER_SIZE))
+    {
+        close();
+        message = path + " is too short to be a search trace";
+        return false;
+    }
+    if (std::memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0)
+    {
+        close();
+        message = path + " is not a search trace";
+        return false;
+    }
+
+    n = static_cast<int>(loadLittle(data + 8, 2));
+    flags = data[10];
+    interval = static_cast<uint32_t>(loadLittle(data + 12, 4));
+    count = loadLittle(data + 16, 8);
+    solutionCount = loadLittle(data + 24, 8);
+    uint64_t body = file.size() - TRACE_HEADER_SIZE;
+    if (n < 1 || n > MAX_BOARD_SIZE || interval == 0 || count > body / 2 ||
+        (body - 2 * count) / (9 + n) < count / interval + 1)
+    {
+        close();
+        message = path + " has a damaged header or is truncated";
+        return false;
+    }
+    keyframeTable = data + TRACE_HEADER_SIZE + 2 * count;
+
+    // The cursor indexes its board with these bytes, so every event and
+    // keyframe has to stay on the board: one linear pass over the file
+    const uint8_t *events = data + TRACE_HEADER_SIZE;
+    for (uint64_t k = 0; k < count; k++)
+    {
+        if ((events[2 * k] & ~TRACE_REMOVED) >= n || events[2 * k + 1] >= n)
+        {
+            close();
+            message = path + " has an event off the board";
+            return false;
+        }
+    }
+    for (uint64_t k = 0; k < keyframes(); k++)
+    {
+        const uint8_t *frame = keyframe(k);
+        bool damaged = frame[8] > n;
+        for (int row = 0; !damaged && row < frame[8]; row++)
+        {
+            damaged = frame[9 + row] >= n;
+        }
+        if (damaged)
+        {
+            close();
+            message = path + " has a keyframe off the board";
+            return false;
+        }
+    }
+    message.clear();
+    return true;
+}
+
+void SearchTrace::close()
+{
+    file.close();
+    data = nullptr;
+    keyframeTable = nullptr;
+    n = 0;
+    flags = 0;
+    interval = 0;
+    count = solutionCount = 0;
+}
+
+uint64_t SearchTrace::keyframeSolutions(uint64_t k) const
+{
+    return loadLittle(keyframe(k), 8);
+}
+
+TraceCursor::TraceCursor(const SearchTrace &trace) : trace(trace)
+{
+    rewind();
+}
+
+void TraceCursor::load(uint64_t k)
+{
+    const uint8_t *frame = trace.keyframe(k);
+    at = k * trace.keyframeInterval();
+    found = loadLittle(frame, 8);
+    queens = frame[8];
+    for (int row = 0; row < queens; row++)
+    {
+        columns[row] = frame[9 + row];
+    }
+}
+
+void TraceCursor::apply(const TraceEvent &event)
+{
+    if (event.removed)
+    {
+        queens = event.row;
+    }
+    else
+    {
+        columns[event.row] = event.col;
+        queens = event.row + 1;
+        if (queens == trace.boardSize())
+            found++;
+    }
+    last = event;
+    at++;
+}
+
+void TraceCursor::seek(uint64_t position)
+{
+    if (!trace.isOpen())
+    {
+        at = 0;
+        queens = 0;
+        found = 0;
+        last = TraceEvent{-1, -1, false};
+        return;
+    }
+    if (position > trace.size())
+    {
+        position = trace.size();
+    }
+    load(position / trace.keyframeInterval());
+    while (at < position)
+    {
+        apply(trace.event(at));
+    }
+    last = at > 0 ? trace.event(at - 1) : TraceEvent{-1, -1, false};
+}
+
+uint64_t TraceCursor::advance(uint64_t count)
+{
+    uint64_t end = trace.size() - at < count ? trace.size() : at + count;
+    uint64_t applied = end - at;
+    while (at < end)
+    {
+        apply(trace.event(at));
+    }
+    return applied;
+}
+
+bool TraceCursor::seekSolution(uint64_t k)
+{
+    if (!trace.isOpen() || k >= trace.solutions())
+    {
+        return false;
+    }
+
+    // Last keyframe with at most k solutions behind it; solution k is
+    // completed within the interval that follows it
+    uint64_t low = 0;
+    uint64_t high = trace.keyframes() - 1;
+    while (low < high)
+    {
+        uint64_t middle = low + (high - low + 1) / 2;
+        if (trace.keyframeSolutions(middle) <= k)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    load(low);
+    last = at > 0 ? trace.event(at - 1) : TraceEvent{-1, -1, false};
+    while (found <= k && at < trace.size())
+    {
+        apply(trace.event(at));
+    }
+    return found > k;
+}
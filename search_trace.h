@@ -0,0 +1,193 @@
+#ifndef SEARCH_TRACE_H
+#define SEARCH_TRACE_H
+
+#include "binary_file.h"
+#include "solver.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary trace of a backtracking search: every queen placed and every queen
+// taken back, in order, so a viewer can replay the search at any speed
+// without running it. A 32-byte little-endian header is followed by one
+// 2-byte event per step and then the keyframe table.
+//
+//   offset  size  field
+//        0     8  magic "NQTRACE1"
+//        8     2  n
+//       10     1  flags (TRACE_ALL_SOLUTIONS, TRACE_COMPLETE)
+//       11     1  reserved, zero
+//       12     4  keyframeInterval
+//       16     8  eventCount
+//       24     8  solutions
+//
+// An event is the row (the depth it happens at) with TRACE_REMOVED set for a
+// queen taken back, then the column. Keyframe k is the board after
+// k * keyframeInterval events: 8 bytes of solutions found so far, one byte of
+// depth and one column byte per row. There are eventCount / keyframeInterval
+// + 1 of them, so any position is at most keyframeInterval - 1 events from a
+// stored board.
+const int TRACE_HEADER_SIZE = 32;
+const uint8_t TRACE_ALL_SOLUTIONS = 1; // the search went on past the first solution
+const uint8_t TRACE_COMPLETE = 2;      // the search finished; it was not cut short
+const uint8_t TRACE_REMOVED = 0x80;
+const uint32_t TRACE_DEFAULT_INTERVAL = 4096;
+
+struct TraceEvent
+{
+    int row;
+    int col;
+    bool removed;
+};
+
+// Appends events to a new trace through a 1 MB buffer. Keyframes are kept in
+// memory (a few bytes per keyframeInterval events) and written by close(),
+// which also fills in the header counts.
+class SearchTraceWriter
+{
+public:
+    SearchTraceWriter(const std::string &path, int n, bool allSolutions,
+                      uint32_t keyframeInterval = TRACE_DEFAULT_INTERVAL);
+    ~SearchTraceWriter();
+
+    SearchTraceWriter(const SearchTraceWriter &) = delete;
+    SearchTraceWriter &operator=(const SearchTraceWriter &) = delete;
+
+    bool good() const { return ok && out.good(); }
+    uint64_t events() const { return written; }
+    uint64_t solutions() const { return found; }
+
+    // A queen onto (depth, col), or the queen of row depth - 1 taken back
+    void place(int col);
+    void remove();
+
+    // The search ran to its end; recorded in the header by close()
+    void markComplete() { flags |= TRACE_COMPLETE; }
+
+    bool close(); // false if any write failed
+
+private:
+    void add(uint8_t row, uint8_t col);
+    void keyframe();
+
+    BufferedFileWriter out;
+    int n;
+    uint32_t interval;
+    uint8_t flags;
+    int depth;
+    int columns[MAX_BOARD_SIZE];
+    uint64_t written;
+    uint64_t found;
+    bool ok; // the arguments were valid and the header went out
+    bool closed;
+    std::vector<uint8_t> keyframes;
+};
+
+struct TraceRecording
+{
+    bool ok = false;
+    std::string error;
+    uint64_t events = 0;
+    uint64_t solutions = 0;
+    bool complete = false; // the search ran out before maxEvents
+};
+
+// Runs StepwiseSolver on an n x n board (1..MAX_BOARD_SIZE) and writes each
+// step to path. With allSolutions the search enumerates every solution
+// instead of stopping at the first; maxEvents (0 = no limit) cuts it short.
+TraceRecording recordSearchTrace(const std::string &path, int n, bool allSolutions, uint64_t maxEvents = 0);
+
+// Read-only view of a trace. The file is memory-mapped (read in once on
+// Windows) and events are decoded straight from the mapping.
+class SearchTrace
+{
+public:
+    SearchTrace();
+    ~SearchTrace();
+
+    SearchTrace(const SearchTrace &) = delete;
+    SearchTrace &operator=(const SearchTrace &) = delete;
+
+    // False (with error() set) if the file is missing, truncated or not a trace
+    bool open(const std::string &path);
+    void close();
+    const std::string &error() const { return message; }
+
+    bool isOpen() const { return data != nullptr; }
+    int boardSize() const { return n; }
+    uint64_t size() const { return count; } // events
+    uint64_t solutions() const { return solutionCount; }
+    bool allSolutions() const { return (flags & TRACE_ALL_SOLUTIONS) != 0; }
+    bool complete() const { return (flags & TRACE_COMPLETE) != 0; }
+    uint32_t keyframeInterval() const { return interval; }
+    uint64_t keyframes() const { return count / interval + 1; }
+
+    // Event k, k < size()
+    TraceEvent event(uint64_t k) const
+    {
+        const uint8_t *record = data + TRACE_HEADER_SIZE + 2 * k;
+        return TraceEvent{record[0] & ~TRACE_REMOVED, record[1], (record[0] & TRACE_REMOVED) != 0};
+    }
+
+private:
+    friend class TraceCursor;
+    const uint8_t *keyframe(uint64_t k) const { return keyframeTable + k * (9 + n); }
+    uint64_t keyframeSolutions(uint64_t k) const;
+
+    MappedFile file;
+    const uint8_t *data;
+    const uint8_t *keyframeTable;
+    int n;
+    uint8_t flags;
+    uint32_t interval;
+    uint64_t count;
+    uint64_t solutionCount;
+    std::string message;
+};
+
+// A position in an open trace: the board after position() events. Moving
+// forward applies events one by one; seek() starts from the nearest keyframe
+// at or before the target, so a jump anywhere costs at most one keyframe
+// interval of events.
+class TraceCursor
+{
+public:
+    explicit TraceCursor(const SearchTrace &trace);
+
+    // Back to the empty board before event 0
+    void rewind() { seek(0); }
+
+    // Board after `position` events (clamped to the end of the trace)
+    void seek(uint64_t position);
+
+    // Applies up to count events; returns how many were applied
+    uint64_t advance(uint64_t count);
+
+    // Board at the moment solution k (0-based) is completed. The keyframe to
+    // start from is found by binary search over the solution counts. False
+    // when the trace holds k solutions or fewer.
+    bool seekSolution(uint64_t k);
+
+    uint64_t position() const { return at; }
+    bool atEnd() const { return at == trace.size(); }
+    int depth() const { return queens; }             // rows 0..depth()-1 hold a queen
+    const int *placement() const { return columns; } // placement()[row] = col
+    uint64_t solutions() const { return found; }     // completed within the first position() events
+
+    // The event that led to this board; row is -1 at position 0
+    TraceEvent lastEvent() const { return last; }
+
+private:
+    void apply(const TraceEvent &event);
+    void load(uint64_t keyframe);
+
+    const SearchTrace &trace;
+    uint64_t at;
+    int queens;
+    int columns[MAX_BOARD_SIZE];
+    uint64_t found;
+    TraceEvent last;
+};
+
+#endif
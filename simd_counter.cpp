@@ -0,0 +1,185 @@
+#include "simd_counter.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+bool avx2Available()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+CountEngine resolveEngine(CountEngine engine)
+{
+    if (engine == ENGINE_SCALAR)
+    {
+        return ENGINE_SCALAR;
+    }
+    return avx2Available() ? ENGINE_AVX2 : ENGINE_SCALAR;
+}
+
+const char *engineName(CountEngine engine)
+{
+    switch (engine)
+    {
+    case ENGINE_SCALAR:
+        return "scalar";
+    case ENGINE_AVX2:
+        return "avx2";
+    default:
+        return "auto";
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+const int LANES = 16; // four 256-bit vectors of four 64-bit lanes
+
+// States waiting at row n - 3, stored lane by lane so they load as vectors
+struct alignas(32) LaneBatch
+{
+    uint64_t cols[LANES];
+    uint64_t left[LANES];
+    uint64_t right[LANES];
+    int used;
+};
+
+__attribute__((target("avx2"), always_inline)) static inline __m256i isClear(__m256i bits, __m256i attacked)
+{
+    return _mm256_cmpeq_epi64(_mm256_and_si256(bits, attacked), _mm256_setzero_si256());
+}
+
+// Finishes the last three rows of every queued state without branching. Three
+// rows left means exactly three free columns, so the six orders they can be
+// placed in are tested directly, four subtrees per vector. Compare masks are
+// all ones, so subtracting them counts placements and solutions per lane.
+__attribute__((target("avx2"))) static void flushBatch(uint64_t full, LaneBatch &batch, uint64_t &solutions, uint64_t &nodes)
+{
+    for (int lane = batch.used; lane < LANES; lane++)
+    {
+        batch.cols[lane] = full; // no free columns: contributes nothing
+        batch.left[lane] = 0;
+        batch.right[lane] = 0;
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i fullMask = _mm256_set1_epi64x(static_cast<long long>(full));
+    __m256i placedCount = zero;
+    __m256i leafCount = zero;
+    for (int v = 0; v < LANES; v += 4)
+    {
+        __m256i cols = _mm256_load_si256(reinterpret_cast<const __m256i *>(batch.cols + v));
+        __m256i left = _mm256_load_si256(reinterpret_cast<const __m256i *>(batch.left + v));
+        __m256i right = _mm256_load_si256(reinterpret_cast<const __m256i *>(batch.right + v));
+
+        // The three free columns, lowest first
+        __m256i remaining = _mm256_andnot_si256(cols, fullMask);
+        __m256i live = _mm256_xor_si256(_mm256_cmpeq_epi64(remaining, zero), _mm256_set1_epi64x(-1));
+        __m256i x = _mm256_and_si256(remaining, _mm256_sub_epi64(zero, remaining));
+        __m256i rest = _mm256_xor_si256(remaining, x);
+        __m256i y = _mm256_and_si256(rest, _mm256_sub_epi64(zero, rest));
+        __m256i z = _mm256_xor_si256(rest, y);
+        __m256i columns[3] = {x, y, z};
+
+        for (int first = 0; first < 3; first++)
+        {
+            __m256i p = columns[first];
+            __m256i okP = _mm256_and_si256(live, isClear(p, _mm256_or_si256(left, right)));
+            __m256i left1 = _mm256_slli_epi64(_mm256_or_si256(left, p), 1);
+            __m256i right1 = _mm256_srli_epi64(_mm256_or_si256(right, p), 1);
+            placedCount = _mm256_sub_epi64(placedCount, okP);
+
+            for (int second = 0; second < 3; second++)
+            {
+                if (second == first)
+                    continue;
+                __m256i q = columns[second];
+                __m256i s = columns[3 - first - second];
+                __m256i okQ = _mm256_and_si256(okP, isClear(q, _mm256_or_si256(left1, right1)));
+                __m256i attacked2 = _mm256_or_si256(_mm256_slli_epi64(_mm256_or_si256(left1, q), 1),
+                                                    _mm256_srli_epi64(_mm256_or_si256(right1, q), 1));
+                __m256i okS = _mm256_and_si256(okQ, isClear(s, attacked2));
+                placedCount = _mm256_sub_epi64(placedCount, _mm256_add_epi64(okQ, okS));
+                leafCount = _mm256_sub_epi64(leafCount, okS);
+            }
+        }
+    }
+
+    alignas(32) uint64_t placed[4];
+    alignas(32) uint64_t leaves[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(placed), placedCount);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(leaves), leafCount);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        solutions += leaves[lane];
+        nodes += placed[lane];
+    }
+    batch.used = 0;
+}
+
+static void searchBatched(int n, uint64_t full, int row, uint64_t cols, uint64_t left, uint64_t right,
+                          LaneBatch &batch, uint64_t &solutions, uint64_t &nodes)
+{
+    if (row == n - 3)
+    {
+        batch.cols[batch.used] = cols;
+        batch.left[batch.used] = left;
+        batch.right[batch.used] = right;
+        if (++batch.used == LANES)
+        {
+            flushBatch(full, batch, solutions, nodes);
+        }
+        return;
+    }
+
+    uint64_t free = full & ~(cols | left | right);
+    while (free)
+    {
+        uint64_t bit = free & (0 - free);
+        free ^= bit;
+        nodes++;
+        searchBatched(n, full, row + 1, cols | bit, (left | bit) << 1, (right | bit) >> 1, batch, solutions, nodes);
+    }
+}
+
+static uint64_t countAvx2(int n, const SearchState &state, uint64_t &nodes)
+{
+    LaneBatch batch;
+    batch.used = 0;
+    uint64_t solutions = 0;
+    uint64_t full = boardMask(n);
+    searchBatched(n, full, state.row, state.cols, state.left, state.right, batch, solutions, nodes);
+    if (batch.used > 0)
+    {
+        flushBatch(full, batch, solutions, nodes);
+    }
+    return solutions;
+}
+
+#endif
+
+uint64_t countCompletionsWith(CountEngine engine, int n, const SearchState &state, uint64_t *nodes)
+{
+    // Boards or states with fewer than three rows left go straight to the scalar search
+    if (resolveEngine(engine) == ENGINE_SCALAR || n < 3 || n > MAX_BOARD_SIZE || state.row > n - 3)
+    {
+        return countCompletions(n, state, nodes);
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    uint64_t visited = 0;
+    uint64_t count = countAvx2(n, state, visited);
+    if (nodes)
+    {
+        *nodes += visited;
+    }
+    return count;
+#else
+    return countCompletions(n, state, nodes);
+#endif
+}
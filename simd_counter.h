@@ -0,0 +1,30 @@
+#ifndef SIMD_COUNTER_H
+#define SIMD_COUNTER_H
+
+#include "solver.h"
+
+#include <cstdint>
+
+// Inner loop used to count solutions
+enum CountEngine
+{
+    ENGINE_AUTO,   // AVX2 when the CPU has it, scalar otherwise
+    ENGINE_SCALAR, // countCompletions(), one node at a time
+    ENGINE_AVX2    // four subtrees per instruction
+};
+
+// True when this CPU supports AVX2 (checked once at run time)
+bool avx2Available();
+
+// The engine that will actually run: ENGINE_AUTO and an unsupported
+// ENGINE_AVX2 both resolve to what the CPU can do
+CountEngine resolveEngine(CountEngine engine);
+
+const char *engineName(CountEngine engine);
+
+// Same result and node count as countCompletions(). With AVX2 the search runs
+// scalar down to row n - 3, where states are queued four at a time and their
+// last three rows finished together in 256-bit registers, one lane per subtree.
+uint64_t countCompletionsWith(CountEngine engine, int n, const SearchState &state, uint64_t *nodes = nullptr);
+
+#endif
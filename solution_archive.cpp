@@ -0,0 +1,176 @@
+#include "solution_archive.h"
+
+#include <cstring>
+
+static const char ARCHIVE_MAGIC[8] = {'N', 'Q', 'S', 'O', 'L', 'V', 'E', '1'};
+
+int archiveColumnBits(int n)
+{
+    int bits = 1;
+    while ((1 << bits) < n)
+    {
+        bits++;
+    }
+    return bits;
+}
+
+SolutionArchiveWriter::SolutionArchiveWriter(const std::string &path, int n, bool fundamentalOnly)
+    : out(path), n(n), bits(archiveColumnBits(n)), recordBytes((n * archiveColumnBits(n) + 7) / 8),
+      flags(fundamentalOnly ? ARCHIVE_FUNDAMENTAL_ONLY : 0), written(0), ok(n >= 1 && n <= 0xFFFF && out.good()),
+      closed(false)
+{
+    // Header goes out now with a zero count; close() patches the count
+    uint8_t header[ARCHIVE_HEADER_SIZE] = {};
+    std::memcpy(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    storeLittle(header + 8, static_cast<uint64_t>(n), 2);
+    header[10] = static_cast<uint8_t>(bits);
+    header[11] = flags;
+    storeLittle(header + 12, static_cast<uint64_t>(recordBytes), 4);
+    if (ok)
+    {
+        out.write(header, sizeof(header));
+    }
+}
+
+SolutionArchiveWriter::~SolutionArchiveWriter()
+{
+    close();
+}
+
+void SolutionArchiveWriter::add(const int *placement)
+{
+    if (!ok)
+    {
+        return;
+    }
+    // Pack the columns into the record, eight bits at a time
+    uint8_t *record = out.reserve(recordBytes);
+    std::memset(record, 0, recordBytes);
+    uint64_t pending = 0;
+    int pendingBits = 0;
+    int byte = 0;
+    for (int row = 0; row < n; row++)
+    {
+        pending |= static_cast<uint64_t>(placement[row]) << pendingBits;
+        pendingBits += bits;
+        while (pendingBits >= 8)
+        {
+            record[byte++] = static_cast<uint8_t>(pending);
+            pending >>= 8;
+            pendingBits -= 8;
+        }
+    }
+    if (pendingBits > 0)
+    {
+        record[byte] = static_cast<uint8_t>(pending);
+    }
+
+    written++;
+}
+
+bool SolutionArchiveWriter::close()
+{
+    if (closed)
+    {
+        return good();
+    }
+    closed = true;
+    if (ok)
+    {
+        uint8_t countBytes[8];
+        storeLittle(countBytes, written, 8);
+        out.patch(16, countBytes, sizeof(countBytes));
+    }
+    ok = out.close() && ok;
+    return ok;
+}
+
+SolutionArchive::SolutionArchive()
+    : data(nullptr), n(0), bits(0), recordBytes(0), flags(0), count(0)
+{
+}
+
+SolutionArchive::~SolutionArchive()
+{
+    close();
+}
+
+bool SolutionArchive::open(const std::string &path)
+{
+    close();
+
+    if (!file.open(path))
+    {
+        message = file.error();
+        return false;
+    }
+    data = file.data();
+    if (file.size() < static_cast<size_t>(ARCHIVE_HEADER_SIZE))
+    {
+        close();
+        message = path + " is too short to be a solution archive";
+        return false;
+    }
+    if (std::memcmp(data, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0)
+    {
+        close();
+        message = path + " is not a solution archive";
+        return false;
+    }
+
+    n = static_cast<int>(loadLittle(data + 8, 2));
+    bits = data[10];
+    flags = data[11];
+    recordBytes = static_cast<int>(loadLittle(data + 12, 4));
+    count = loadLittle(data + 16, 8);
+    if (n < 1 || bits != archiveColumnBits(n) || recordBytes != (n * bits + 7) / 8 ||
+        (file.size() - ARCHIVE_HEADER_SIZE) / recordBytes < count)
+    {
+        close();
+        message = path + " has a damaged header or is truncated";
+        return false;
+    }
+    message.clear();
+    return true;
+}
+
+void SolutionArchive::close()
+{
+    file.close();
+    data = nullptr;
+    n = bits = recordBytes = 0;
+    flags = 0;
+    count = 0;
+}
+
+int SolutionArchive::column(uint64_t k, int row) const
+{
+    // A column spans at most three bytes (bits <= 16 for n <= 65535); read only
+    // the bytes that exist so the last record never reads past the mapping
+    const uint8_t *record = data + ARCHIVE_HEADER_SIZE + k * recordBytes;
+    int bit = row * bits;
+    int first = bit >> 3;
+    int span = ((bit & 7) + bits + 7) >> 3;
+    uint64_t window = loadLittle(record + first, span);
+    return static_cast<int>((window >> (bit & 7)) & ((1ULL << bits) - 1));
+}
+
+void SolutionArchive::solution(uint64_t k, int *placement) const
+{
+    const uint8_t *record = data + ARCHIVE_HEADER_SIZE + k * recordBytes;
+    uint64_t pending = 0;
+    int pendingBits = 0;
+    int byte = 0;
+    uint64_t mask = (1ULL << bits) - 1;
+    for (int row = 0; row < n; row++)
+    {
+        while (pendingBits < bits)
+        {
+            pending |= static_cast<uint64_t>(record[byte++]) << pendingBits;
+            pendingBits += 8;
+        }
+        placement[row] = static_cast<int>(pending & mask);
+        pending >>= bits;
+        pendingBits -= bits;
+    }
+}
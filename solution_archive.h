@@ -0,0 +1,95 @@
+#ifndef SOLUTION_ARCHIVE_H
+#define SOLUTION_ARCHIVE_H
+
+#include "binary_file.h"
+
+#include <cstdint>
+#include <string>
+
+// Binary solution file. A 32-byte little-endian header is followed by one
+// fixed-size record per solution, so record k starts at
+// ARCHIVE_HEADER_SIZE + k * recordBytes. A record stores placement[row] for
+// every row in bitsPerColumn bits, row 0 in the lowest bits, padded to whole
+// bytes.
+//
+//   offset  size  field
+//        0     8  magic "NQSOLVE1"
+//        8     2  n
+//       10     1  bitsPerColumn
+//       11     1  flags (ARCHIVE_FUNDAMENTAL_ONLY)
+//       12     4  recordBytes
+//       16     8  count
+//       24     8  reserved, zero
+const int ARCHIVE_HEADER_SIZE = 32;
+const uint8_t ARCHIVE_FUNDAMENTAL_ONLY = 1; // one canonical form per symmetry class
+
+// Bits needed to store a column of an n x n board
+int archiveColumnBits(int n);
+
+// Appends solutions to a new archive through a 1 MB buffer. The count in the
+// header is filled in by close() (or the destructor).
+class SolutionArchiveWriter
+{
+public:
+    SolutionArchiveWriter(const std::string &path, int n, bool fundamentalOnly);
+    ~SolutionArchiveWriter();
+
+    SolutionArchiveWriter(const SolutionArchiveWriter &) = delete;
+    SolutionArchiveWriter &operator=(const SolutionArchiveWriter &) = delete;
+
+    bool good() const { return ok && out.good(); }
+    uint64_t count() const { return written; }
+
+    void add(const int *placement);
+    bool close(); // false if any write failed
+
+private:
+    BufferedFileWriter out;
+    int n;
+    int bits;
+    int recordBytes;
+    uint8_t flags;
+    uint64_t written;
+    bool ok; // the arguments were valid and the header went out
+    bool closed;
+};
+
+// Read-only view of an archive. The file is memory-mapped and records are
+// decoded straight from the mapping, so opening is O(1) whatever the size and
+// the k-th solution costs one record's worth of bit extraction.
+class SolutionArchive
+{
+public:
+    SolutionArchive();
+    ~SolutionArchive();
+
+    SolutionArchive(const SolutionArchive &) = delete;
+    SolutionArchive &operator=(const SolutionArchive &) = delete;
+
+    // False (with error() set) if the file is missing, truncated or not an archive
+    bool open(const std::string &path);
+    void close();
+    const std::string &error() const { return message; }
+
+    int boardSize() const { return n; }
+    uint64_t size() const { return count; }
+    bool fundamentalOnly() const { return (flags & ARCHIVE_FUNDAMENTAL_ONLY) != 0; }
+
+    // Column of `row` in solution k; k < size(), row < boardSize()
+    int column(uint64_t k, int row) const;
+
+    // Decodes solution k into placement[0..boardSize())
+    void solution(uint64_t k, int *placement) const;
+
+private:
+    MappedFile file;
+    const uint8_t *data;
+    int n;
+    int bits;
+    int recordBytes;
+    uint8_t flags;
+    uint64_t count;
+    std::string message;
+};
+
+#endif
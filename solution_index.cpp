@@ -0,0 +1,310 @@
+#include "solution_index.h"
+#include "simd_counter.h"
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// Solutions below a state; a full board is one solution
+static uint64_t completionsBelow(int n, const SearchState &state, uint64_t *nodes)
+{
+    return state.row == n ? 1 : countCompletionsWith(ENGINE_AUTO, n, state, nodes);
+}
+
+// Lists every prefix `remaining` rows below state, in lexicographic order
+static void listPrefixes(int n, uint64_t full, const SearchState &state, int remaining, uint8_t *path,
+                         std::vector<SearchState> &states, std::vector<uint8_t> &columns)
+{
+    if (remaining == 0)
+    {
+        states.push_back(state);
+        columns.insert(columns.end(), path, path + state.row);
+        return;
+    }
+
+    uint64_t free = freeColumns(state, full);
+    while (free)
+    {
+        uint64_t bit = free & (0 - free);
+        free ^= bit;
+        path[state.row] = static_cast<uint8_t>(lowestBit(bit));
+        listPrefixes(n, full, advance(state, bit), remaining - 1, path, states, columns);
+    }
+}
+
+SolutionIndex::SolutionIndex() : n(0), depth(0), threads(0), solutions(0)
+{
+}
+
+bool SolutionIndex::build(int size, int prefixDepth, int threadCount)
+{
+    n = 0;
+    depth = 0;
+    solutions = 0;
+    frontier.clear();
+    columns.clear();
+    if (size < 1 || size > MAX_BOARD_SIZE)
+    {
+        return false;
+    }
+    int rows = std::max(0, std::min(prefixDepth, size));
+
+    std::vector<SearchState> states;
+    std::vector<uint8_t> allColumns;
+    uint8_t path[MAX_BOARD_SIZE];
+    listPrefixes(size, boardMask(size), rootState(), rows, path, states, allColumns);
+
+    std::vector<uint64_t> counts(states.size());
+    {
+        WorkStealingPool pool(threadCount);
+        for (size_t i = 0; i < states.size(); i++)
+        {
+            pool.submit([&, i](int)
+                        { counts[i] = completionsBelow(size, states[i], nullptr); });
+        }
+        pool.wait();
+        threads = pool.threadCount();
+    }
+
+    // Keep only prefixes that lead somewhere, with running totals
+    for (size_t i = 0; i < states.size(); i++)
+    {
+        if (counts[i] == 0)
+        {
+            continue;
+        }
+        frontier.push_back(Prefix{states[i], counts[i], solutions});
+        columns.insert(columns.end(), allColumns.begin() + i * rows, allColumns.begin() + (i + 1) * rows);
+        solutions += counts[i];
+    }
+
+    n = size;
+    depth = rows;
+    return true;
+}
+
+bool SolutionIndex::unrank(uint64_t k, int *placement, uint64_t *nodes) const
+{
+    if (!ready() || k >= solutions)
+    {
+        return false;
+    }
+
+    // Last prefix whose first solution is at or before k
+    auto entry = std::upper_bound(frontier.begin(), frontier.end(), k,
+                                  [](uint64_t value, const Prefix &prefix)
+                                  { return value < prefix.before; }) -
+                 1;
+    size_t index = static_cast<size_t>(entry - frontier.begin());
+    for (int row = 0; row < depth; row++)
+    {
+        placement[row] = columns[index * depth + row];
+    }
+    k -= entry->before;
+
+    // Below the frontier: skip whole sibling subtrees until k falls inside one
+    uint64_t full = boardMask(n);
+    SearchState state = entry->state;
+    while (state.row < n)
+    {
+        uint64_t free = freeColumns(state, full);
+        bool descended = false;
+        while (free && !descended)
+        {
+            uint64_t bit = free & (0 - free);
+            free ^= bit;
+            SearchState child = advance(state, bit);
+            uint64_t count = completionsBelow(n, child, nodes);
+            if (k < count)
+            {
+                placement[state.row] = lowestBit(bit);
+                state = child;
+                descended = true;
+            }
+            else
+            {
+                k -= count;
+            }
+        }
+        if (!descended)
+        {
+            return false; // the prefix's count promised more solutions than it has
+        }
+    }
+    return true;
+}
+
+bool SolutionIndex::rank(const int *placement, uint64_t &k, uint64_t *nodes) const
+{
+    if (!ready())
+    {
+        return false;
+    }
+    for (int row = 0; row < n; row++)
+    {
+        if (placement[row] < 0 || placement[row] >= n)
+        {
+            return false;
+        }
+    }
+
+    // Frontier entries are sorted by their prefix columns
+    size_t low = 0;
+    size_t high = frontier.size();
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        const uint8_t *prefix = columns.data() + middle * depth;
+        bool less = std::lexicographical_compare(prefix, prefix + depth, placement, placement + depth,
+                                                 [](int a, int b)
+                                                 { return a < b; });
+        if (less)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == frontier.size() || !std::equal(placement, placement + depth, columns.data() + low * depth))
+    {
+        return false; // no solution starts with these rows
+    }
+
+    // Below the frontier: count the solutions in every smaller sibling subtree
+    uint64_t full = boardMask(n);
+    SearchState state = frontier[low].state;
+    uint64_t position = frontier[low].before;
+    while (state.row < n)
+    {
+        uint64_t bit = 1ULL << placement[state.row];
+        uint64_t free = freeColumns(state, full);
+        if (!(free & bit))
+        {
+            return false; // the queen is attacked
+        }
+        for (uint64_t smaller = free & (bit - 1); smaller; smaller &= smaller - 1)
+        {
+            position += completionsBelow(n, advance(state, smaller & (0 - smaller)), nodes);
+        }
+        state = advance(state, bit);
+    }
+    k = position;
+    return true;
+}
+
+static const char INDEX_MAGIC[8] = {'N', 'Q', 'I', 'N', 'D', 'E', 'X', '1'};
+
+static void putLittle(std::ofstream &out, uint64_t value, int bytes)
+{
+    char raw[8];
+    for (int i = 0; i < bytes; i++)
+    {
+        raw[i] = static_cast<char>(value >> (8 * i));
+    }
+    out.write(raw, bytes);
+}
+
+static bool getLittle(std::ifstream &in, uint64_t &value, int bytes)
+{
+    unsigned char raw[8];
+    if (!in.read(reinterpret_cast<char *>(raw), bytes))
+    {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        value |= static_cast<uint64_t>(raw[i]) << (8 * i);
+    }
+    return true;
+}
+
+bool SolutionIndex::save(const std::string &path) const
+{
+    if (!ready())
+    {
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    putLittle(out, static_cast<uint64_t>(n), 2);
+    putLittle(out, static_cast<uint64_t>(depth), 2);
+    putLittle(out, frontier.size(), 8);
+    for (size_t i = 0; i < frontier.size(); i++)
+    {
+        putLittle(out, frontier[i].state.cols, 8);
+        putLittle(out, frontier[i].state.left, 8);
+        putLittle(out, frontier[i].state.right, 8);
+        putLittle(out, frontier[i].count, 8);
+        out.write(reinterpret_cast<const char *>(&columns[i * depth]), depth);
+    }
+    return out.good();
+}
+
+bool SolutionIndex::load(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(INDEX_MAGIC)];
+    uint64_t size = 0;
+    uint64_t rows = 0;
+    uint64_t entries = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+        !getLittle(in, size, 2) || !getLittle(in, rows, 2) || !getLittle(in, entries, 8) ||
+        size < 1 || size > static_cast<uint64_t>(MAX_BOARD_SIZE) || rows > size)
+    {
+        return false;
+    }
+
+    // Each entry is four 8-byte words and its prefix columns; a count the
+    // rest of the file cannot hold is damage, not something to allocate for
+    std::streampos start = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff remaining = in.tellg() - start;
+    in.seekg(start);
+    if (!in || remaining < 0 || entries > static_cast<uint64_t>(remaining) / (32 + rows))
+    {
+        return false;
+    }
+
+    std::vector<Prefix> loaded;
+    loaded.reserve(entries);
+    std::vector<uint8_t> loadedColumns(entries * rows);
+    uint64_t running = 0;
+    for (uint64_t i = 0; i < entries; i++)
+    {
+        Prefix prefix;
+        prefix.state.row = static_cast<int>(rows);
+        if (!getLittle(in, prefix.state.cols, 8) || !getLittle(in, prefix.state.left, 8) ||
+            !getLittle(in, prefix.state.right, 8) || !getLittle(in, prefix.count, 8) ||
+            !in.read(reinterpret_cast<char *>(&loadedColumns[i * rows]), static_cast<std::streamsize>(rows)))
+        {
+            return false;
+        }
+        // The columns must be a legal prefix, after the previous one in order,
+        // whose state and count a rebuild would have produced
+        const uint8_t *path = &loadedColumns[i * rows];
+        SearchState state = rootState();
+        for (uint64_t row = 0; row < rows; row++)
+        {
+            uint64_t bit = 1ULL << (path[row] & 63);
+            if (path[row] >= size || !(freeColumns(state, boardMask(static_cast<int>(size))) & bit))
+                return false;
+            state = advance(state, bit);
+        }
+        if (state.cols != prefix.state.cols || state.left != prefix.state.left || state.right != prefix.state.right ||
+            prefix.count == 0 || (i > 0 && !std::lexicographical_compare(path - rows, path, path, path + rows)))
+        {
+            return false;
+        }
+        prefix.before = running;
+        running += prefix.count;
+        loaded.push_back(prefix);
+    }
+
+    n = static_cast<int>(size);
+    depth = static_cast<int>(rows);
+    threads = 0;
+    solutions = running;
+    frontier.swap(loaded);
+    columns.swap(loadedColumns);
+    return true;
+}
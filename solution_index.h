@@ -0,0 +1,65 @@
+#ifndef SOLUTION_INDEX_H
+#define SOLUTION_INDEX_H
+
+#include "solver.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Numbers the solutions of an n x n board 0..total()-1 in lexicographic order
+// of placement[row] = col (the order solveQueens() finds them in; for 8x8 the
+// order of the compile-time table). build() counts the completions below every
+// prefix of the first prefixDepth rows once, so ranking or unranking only has
+// to search below that frontier: a binary search finds the prefix, then at
+// most n - prefixDepth rows of sibling subtrees are counted.
+class SolutionIndex
+{
+public:
+    SolutionIndex();
+
+    // Counts the frontier on threadCount workers (0 = all cores). Deeper
+    // frontiers cost more memory but make each query cheaper. False if n is
+    // outside 1..MAX_BOARD_SIZE.
+    bool build(int n, int prefixDepth, int threadCount = 0);
+
+    // Stores the frontier so a later run can skip the count. The file is
+    // little-endian: magic "NQINDEX1", n (2 bytes), depth (2), prefix count
+    // (8), then per prefix its cols, left, right and count (8 bytes each)
+    // followed by its depth columns (1 byte each).
+    bool save(const std::string &path) const;
+    bool load(const std::string &path); // false if missing or damaged
+
+    bool ready() const { return n > 0; }
+    int boardSize() const { return n; }
+    int prefixDepth() const { return depth; }
+    uint64_t total() const { return solutions; }
+    std::size_t frontierSize() const { return frontier.size(); }
+    int buildThreads() const { return threads; } // workers that counted the frontier
+
+    // Fills placement[0..n) with solution k; false if k >= total().
+    // nodes (optional) is increased by the queens placed below the frontier.
+    bool unrank(uint64_t k, int *placement, uint64_t *nodes = nullptr) const;
+
+    // Position of placement in the order; false if it is not a solution
+    bool rank(const int *placement, uint64_t &k, uint64_t *nodes = nullptr) const;
+
+private:
+    // A frontier prefix with at least one completion
+    struct Prefix
+    {
+        SearchState state; // after the prefix's queens
+        uint64_t count;    // solutions that start with this prefix
+        uint64_t before;   // solutions in earlier prefixes
+    };
+
+    int n;
+    int depth;
+    int threads;
+    uint64_t solutions;
+    std::vector<Prefix> frontier;
+    std::vector<uint8_t> columns; // depth columns per frontier entry
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "solution_sampler.h"
+
+#include <algorithm>
+#include <numeric>
+
+SolutionSampler::SolutionSampler(const SolutionIndex &index, uint64_t seed) : index(index), random(seed)
+{
+}
+
+bool SolutionSampler::sample(int *placement, uint64_t *nodes)
+{
+    if (!index.ready() || index.total() == 0)
+    {
+        return false;
+    }
+    std::uniform_int_distribution<uint64_t> pick(0, index.total() - 1);
+    return index.unrank(pick(random), placement, nodes);
+}
+
+bool SolutionSampler::samplePartial(int queens, std::vector<std::pair<int, int>> &layout)
+{
+    layout.clear();
+    int n = index.boardSize();
+    std::vector<int> placement(n > 0 ? n : 0);
+    if (!sample(placement.data()))
+    {
+        return false;
+    }
+
+    // Partial Fisher-Yates: the first `queens` rows of a shuffled row list
+    std::vector<int> rows(n);
+    std::iota(rows.begin(), rows.end(), 0);
+    queens = std::max(0, std::min(queens, n));
+    for (int i = 0; i < queens; i++)
+    {
+        std::uniform_int_distribution<int> pick(i, n - 1);
+        std::swap(rows[i], rows[pick(random)]);
+    }
+    std::sort(rows.begin(), rows.begin() + queens);
+    for (int i = 0; i < queens; i++)
+    {
+        layout.push_back({rows[i], placement[rows[i]]});
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef SOLUTION_SAMPLER_H
+#define SOLUTION_SAMPLER_H
+
+#include "solution_index.h"
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Draws solutions uniformly at random: a uniform rank in 0..total()-1 is
+// unranked through the index, which is a weighted descent by the cached
+// subtree counts. Nothing is rejected or enumerated, so a sample costs one
+// unrank. The index must outlive the sampler.
+class SolutionSampler
+{
+public:
+    explicit SolutionSampler(const SolutionIndex &index, uint64_t seed = 1);
+
+    // Fills placement[0..n) with a uniformly chosen solution; false if the
+    // index is empty. nodes (optional) counts queens placed by the descent.
+    bool sample(int *placement, uint64_t *nodes = nullptr);
+
+    // `queens` (row, col) pairs of a uniformly chosen solution, on rows chosen
+    // uniformly without replacement, sorted by row. The layout therefore
+    // always has at least one completion.
+    bool samplePartial(int queens, std::vector<std::pair<int, int>> &layout);
+
+private:
+    const SolutionIndex &index;
+    std::mt19937_64 random;
+};
+
+#endif
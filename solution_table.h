@@ -0,0 +1,154 @@
+#ifndef SOLUTION_TABLE_H
+#define SOLUTION_TABLE_H
+
+#include <array>
+#include <cstdint>
+
+// Every solution of the 8x8 board, generated by the compiler. Solutions are in
+// lexicographic order of placement[row] = col; each one is tagged with its
+// symmetry class, and the first member of every class is its canonical
+// (smallest) form.
+
+const int TABLE_BOARD_SIZE = 8;
+const int TABLE_SOLUTION_COUNT = 92;
+const int TABLE_FUNDAMENTAL_COUNT = 12;
+
+typedef std::array<uint8_t, TABLE_BOARD_SIZE> TablePlacement;
+
+struct SolutionTable
+{
+    std::array<TablePlacement, TABLE_SOLUTION_COUNT> solutions{};
+    std::array<uint8_t, TABLE_SOLUTION_COUNT> classOf{};           // fundamental class of each solution
+    std::array<uint8_t, TABLE_FUNDAMENTAL_COUNT> fundamentals{};   // index of each class's canonical form
+    int count = 0;
+    int fundamentalCount = 0;
+};
+
+namespace solution_table_detail
+{
+    constexpr TablePlacement transform(const TablePlacement &p, int symmetry)
+    {
+        const int n = TABLE_BOARD_SIZE;
+        TablePlacement out{};
+        for (int row = 0; row < n; row++)
+        {
+            int col = p[row];
+            switch (symmetry)
+            {
+            case 0: out[row] = col; break;
+            case 1: out[col] = n - 1 - row; break;
+            case 2: out[n - 1 - row] = n - 1 - col; break;
+            case 3: out[n - 1 - col] = row; break;
+            case 4: out[row] = n - 1 - col; break;
+            case 5: out[n - 1 - row] = col; break;
+            case 6: out[col] = row; break;
+            default: out[n - 1 - col] = n - 1 - row; break;
+            }
+        }
+        return out;
+    }
+
+    constexpr bool lessThan(const TablePlacement &a, const TablePlacement &b)
+    {
+        for (int i = 0; i < TABLE_BOARD_SIZE; i++)
+        {
+            if (a[i] != b[i])
+                return a[i] < b[i];
+        }
+        return false;
+    }
+
+    constexpr bool equal(const TablePlacement &a, const TablePlacement &b)
+    {
+        return !lessThan(a, b) && !lessThan(b, a);
+    }
+
+    constexpr TablePlacement canonical(const TablePlacement &p)
+    {
+        TablePlacement best = p;
+        for (int s = 1; s < 8; s++)
+        {
+            TablePlacement image = transform(p, s);
+            if (lessThan(image, best))
+                best = image;
+        }
+        return best;
+    }
+
+    constexpr void record(SolutionTable &table, const TablePlacement &p)
+    {
+        int index = table.count++;
+        table.solutions[index] = p;
+
+        // Solutions arrive in lexicographic order, so a class's canonical form
+        // is always seen before (or as) any other member of that class
+        TablePlacement smallest = canonical(p);
+        if (equal(smallest, p))
+        {
+            table.fundamentals[table.fundamentalCount] = static_cast<uint8_t>(index);
+            table.classOf[index] = static_cast<uint8_t>(table.fundamentalCount++);
+            return;
+        }
+        for (int c = 0; c < table.fundamentalCount; c++)
+        {
+            if (equal(table.solutions[table.fundamentals[c]], smallest))
+            {
+                table.classOf[index] = static_cast<uint8_t>(c);
+                return;
+            }
+        }
+    }
+
+    constexpr void search(SolutionTable &table, TablePlacement &p, int row, unsigned cols, unsigned left, unsigned right)
+    {
+        if (row == TABLE_BOARD_SIZE)
+        {
+            record(table, p);
+            return;
+        }
+        unsigned free = 0xFFu & ~(cols | left | right);
+        for (int col = 0; col < TABLE_BOARD_SIZE; col++)
+        {
+            unsigned bit = 1u << col;
+            if (free & bit)
+            {
+                p[row] = static_cast<uint8_t>(col);
+                search(table, p, row + 1, cols | bit, (left | bit) << 1, (right | bit) >> 1);
+            }
+        }
+    }
+
+    constexpr SolutionTable build()
+    {
+        SolutionTable table{};
+        TablePlacement p{};
+        search(table, p, 0, 0, 0, 0);
+        return table;
+    }
+}
+
+constexpr SolutionTable EIGHT_QUEENS = solution_table_detail::build();
+
+static_assert(EIGHT_QUEENS.count == TABLE_SOLUTION_COUNT, "the 8x8 board has 92 solutions");
+static_assert(EIGHT_QUEENS.fundamentalCount == TABLE_FUNDAMENTAL_COUNT, "the 8x8 board has 12 fundamental solutions");
+static_assert(EIGHT_QUEENS.solutions[0][1] == 4 && EIGHT_QUEENS.solutions[0][2] == 7, "first solution is 0 4 7 5 2 6 1 3");
+
+// Index of the first solution (starting at `from`, wrapping around) that agrees
+// with every queen in rows/cols; -1 when no solution contains them all
+constexpr int findTableSolution(const int *rows, const int *cols, int queenCount, int from = 0)
+{
+    for (int step = 0; step < TABLE_SOLUTION_COUNT; step++)
+    {
+        int index = (from + step) % TABLE_SOLUTION_COUNT;
+        bool matches = true;
+        for (int q = 0; q < queenCount && matches; q++)
+        {
+            matches = EIGHT_QUEENS.solutions[index][rows[q]] == cols[q];
+        }
+        if (matches)
+            return index;
+    }
+    return -1;
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "solve_strategy.h"
+#include "solver.h"
+#include "min_conflicts.h"
+#include "constructive_solver.h"
+
+const char *strategyName(SolverStrategy strategy)
+{
+    switch (strategy)
+    {
+    case STRATEGY_BACKTRACK:
+        return "backtrack";
+    case STRATEGY_LOCAL_SEARCH:
+        return "local";
+    case STRATEGY_CONSTRUCTIVE:
+        return "construct";
+    default:
+        return "auto";
+    }
+}
+
+SolverStrategy fastestStrategy(int n)
+{
+    return n <= 12 ? STRATEGY_BACKTRACK : STRATEGY_CONSTRUCTIVE;
+}
+
+SolveResult findPlacement(int n, std::vector<int> &placement, SolverStrategy strategy)
+{
+    if (strategy == STRATEGY_AUTO)
+    {
+        strategy = fastestStrategy(n);
+    }
+    if (strategy == STRATEGY_BACKTRACK && n > MAX_BOARD_SIZE)
+    {
+        strategy = STRATEGY_CONSTRUCTIVE;
+    }
+
+    SolveResult result = {false, strategy, 0};
+    switch (strategy)
+    {
+    case STRATEGY_BACKTRACK:
+        placement.resize(n > 0 ? n : 0);
+        result.found = solveQueens(n, placement.data(), &result.nodes);
+        break;
+    case STRATEGY_LOCAL_SEARCH:
+    {
+        MinConflictsResult local = solveMinConflicts(n, placement);
+        result.found = local.solved;
+        result.nodes = local.swapsTried;
+        break;
+    }
+    default:
+        result.found = constructPlacement(n, placement);
+        result.nodes = result.found ? n : 0;
+        break;
+    }
+
+    if (!result.found)
+    {
+        placement.clear();
+    }
+    return result;
+}
+
+PlacementVerifier::PlacementVerifier(int n)
+    : n(n), rows(0), ok(n > 0),
+      columns((n + 63) / 64), diagonals((2 * static_cast<int64_t>(n) + 63) / 64), antiDiagonals((2 * static_cast<int64_t>(n) + 63) / 64)
+{
+}
+
+bool PlacementVerifier::testAndSet(std::vector<uint64_t> &bits, int64_t index)
+{
+    uint64_t bit = 1ULL << (index & 63);
+    uint64_t &word = bits[index >> 6];
+    bool taken = (word & bit) != 0;
+    word |= bit;
+    return taken;
+}
+
+bool PlacementVerifier::add(int col)
+{
+    if (!ok || rows >= n || col < 0 || col >= n)
+    {
+        ok = false;
+        return false;
+    }
+
+    int64_t row = rows++;
+    bool clash = testAndSet(columns, col);
+    clash |= testAndSet(diagonals, row + col);
+    clash |= testAndSet(antiDiagonals, row - col + n - 1);
+    if (clash)
+    {
+        ok = false;
+    }
+    return ok;
+}
+
+bool verifyPlacement(int n, const int *placement)
+{
+    PlacementVerifier verifier(n);
+    for (int row = 0; row < n; row++)
+    {
+        if (!verifier.add(placement[row]))
+        {
+            return false;
+        }
+    }
+    return verifier.valid();
+}
@@ -0,0 +1,58 @@
+#ifndef SOLVE_STRATEGY_H
+#define SOLVE_STRATEGY_H
+
+#include <cstdint>
+#include <vector>
+
+// Ways of producing one valid placement; all fill placement[row] = col
+enum SolverStrategy
+{
+    STRATEGY_AUTO,         // pick the fastest for the board size
+    STRATEGY_BACKTRACK,    // solveQueens, n <= 64
+    STRATEGY_LOCAL_SEARCH, // solveMinConflicts
+    STRATEGY_CONSTRUCTIVE  // closed-form construction
+};
+
+struct SolveResult
+{
+    bool found;
+    SolverStrategy strategy; // the strategy that actually ran
+    uint64_t nodes;          // queens placed or swaps tried, depending on strategy
+};
+
+const char *strategyName(SolverStrategy strategy);
+
+// Backtracking for small boards, where it is instant and returns the
+// lexicographically first solution; the O(n) construction beyond that.
+SolverStrategy fastestStrategy(int n);
+
+SolveResult findPlacement(int n, std::vector<int> &placement, SolverStrategy strategy = STRATEGY_AUTO);
+
+// Checks a placement row by row in O(n) with occupancy bitsets for the
+// columns and both diagonal families, so huge outputs can be verified while
+// they are streamed.
+class PlacementVerifier
+{
+public:
+    explicit PlacementVerifier(int n);
+
+    // Records the queen of the next row; false once any conflict has been seen
+    bool add(int col);
+
+    // True when exactly n conflict-free queens were added
+    bool valid() const { return ok && rows == n; }
+
+private:
+    bool testAndSet(std::vector<uint64_t> &bits, int64_t index);
+
+    int n;
+    int rows;
+    bool ok;
+    std::vector<uint64_t> columns;
+    std::vector<uint64_t> diagonals;
+    std::vector<uint64_t> antiDiagonals;
+};
+
+bool verifyPlacement(int n, const int *placement);
+
+#endif
@@ -0,0 +1,211 @@
+#include "solver.h"
+#include "solver_stats.h"
+
+static inline bool testBit(const uint64_t *words, int index)
+{
+    return (words[index >> 6] >> (index & 63)) & 1ULL;
+}
+
+static inline void flipBit(uint64_t *words, int index)
+{
+    words[index >> 6] ^= 1ULL << (index & 63);
+}
+
+Bitboard::Bitboard(int n) : size(n)
+{
+    clear();
+}
+
+void Bitboard::clear()
+{
+    rows = 0;
+    cols = 0;
+    diagonals[0] = diagonals[1] = 0;
+    antiDiagonals[0] = antiDiagonals[1] = 0;
+}
+
+bool Bitboard::canPlace(int row, int col) const
+{
+    if ((rows >> row) & 1ULL || (cols >> col) & 1ULL)
+    {
+        return false;
+    }
+    return !testBit(diagonals, row + col) && !testBit(antiDiagonals, row - col + size - 1);
+}
+
+void Bitboard::place(int row, int col)
+{
+    rows |= 1ULL << row;
+    cols |= 1ULL << col;
+    flipBit(diagonals, row + col);
+    flipBit(antiDiagonals, row - col + size - 1);
+}
+
+void Bitboard::remove(int row, int col)
+{
+    rows &= ~(1ULL << row);
+    cols &= ~(1ULL << col);
+    flipBit(diagonals, row + col);
+    flipBit(antiDiagonals, row - col + size - 1);
+}
+
+SearchArena &threadArena()
+{
+    static thread_local SearchArena arena;
+    return arena;
+}
+
+// Row-by-row search. left/right hold the diagonals attacking the current row,
+// shifted one step per row so a bit's index is always the column it blocks.
+// frames[row] is the row being filled; backtracking is a step down the stack.
+// The Instrumented copy also fills `stats`; the plain one never touches it.
+template <bool Instrumented>
+static bool firstSolution(int n, int *placement, uint64_t *nodes, SearchArena &arena, SolverStats *stats)
+{
+    (void)stats; // only read through STATS_ADD, which NQUEENS_NO_STATS compiles out
+    const uint64_t full = boardMask(n);
+    SearchFrame *frames = arena.frames;
+    frames[0] = SearchFrame{0, 0, 0, full};
+    uint64_t visited = 0;
+    bool found = false;
+
+    int row = 0;
+    while (row >= 0)
+    {
+        SearchFrame &frame = frames[row];
+        if (!frame.untried)
+        {
+            if (Instrumented)
+                STATS_ADD(*stats, prunes, 1);
+            row--; // No column works for this row
+            continue;
+        }
+
+        uint64_t bit = frame.untried & (0 - frame.untried);
+        frame.untried ^= bit;
+        placement[row] = lowestBit(bit);
+        visited++;
+        if (Instrumented)
+            STATS_NODE(*stats, row);
+
+        if (row + 1 == n)
+        {
+            found = true; // All queens are placed successfully
+            break;
+        }
+
+        SearchFrame &next = frames[row + 1];
+        next.cols = frame.cols | bit;
+        next.left = (frame.left | bit) << 1;
+        next.right = (frame.right | bit) >> 1;
+        next.untried = full & ~(next.cols | next.left | next.right);
+        if (Instrumented)
+            STATS_ADD(*stats, checks, 1);
+        row++;
+    }
+
+    if (nodes)
+    {
+        *nodes += visited;
+    }
+    if (Instrumented)
+        STATS_ADD(*stats, solutions, found ? 1 : 0);
+    return found;
+}
+
+bool solveQueens(int n, int *placement, uint64_t *nodes, SearchArena &arena, SolverStats *stats)
+{
+    if (n <= 0 || n > MAX_BOARD_SIZE)
+    {
+        return false;
+    }
+    if (STATS_ENABLED && stats)
+    {
+        StatsTimer timer(stats);
+        STATS_ADD(*stats, checks, 1); // row 0
+        return firstSolution<true>(n, placement, nodes, arena, stats);
+    }
+    return firstSolution<false>(n, placement, nodes, arena, nullptr);
+}
+
+bool solveQueens(int n, int *placement, uint64_t *nodes)
+{
+    return solveQueens(n, placement, nodes, threadArena());
+}
+
+template <bool Instrumented>
+static uint64_t searchCount(int n, uint64_t full, int row, uint64_t cols, uint64_t left, uint64_t right, uint64_t &nodes,
+                            SolverStats *stats)
+{
+    if (row == n)
+    {
+        return 1;
+    }
+
+    uint64_t count = 0;
+    uint64_t free = full & ~(cols | left | right);
+    if (Instrumented)
+    {
+        STATS_ADD(*stats, checks, 1);
+        STATS_ADD(*stats, prunes, free ? 0 : 1);
+    }
+    while (free)
+    {
+        uint64_t bit = free & (0 - free);
+        free ^= bit;
+        nodes++;
+        if (Instrumented)
+            STATS_NODE(*stats, row);
+        count += searchCount<Instrumented>(n, full, row + 1, cols | bit, (left | bit) << 1, (right | bit) >> 1, nodes, stats);
+    }
+    return count;
+}
+
+uint64_t countCompletions(int n, const SearchState &state, uint64_t *nodes, SolverStats *stats)
+{
+    if (n <= 0 || n > MAX_BOARD_SIZE)
+    {
+        return 0;
+    }
+
+    uint64_t visited = 0;
+    uint64_t count;
+    if (STATS_ENABLED && stats)
+    {
+        StatsTimer timer(stats);
+        count = searchCount<true>(n, boardMask(n), state.row, state.cols, state.left, state.right, visited, stats);
+        STATS_ADD(*stats, solutions, count);
+    }
+    else
+    {
+        count = searchCount<false>(n, boardMask(n), state.row, state.cols, state.left, state.right, visited, nullptr);
+    }
+    if (nodes)
+    {
+        *nodes += visited;
+    }
+    return count;
+}
+
+uint64_t countSolutions(int n, uint64_t *nodes)
+{
+    return countCompletions(n, rootState(), nodes);
+}
+
+bool knownSolutionCount(int n, uint64_t &count)
+{
+    static const uint64_t counts[] = {
+        1ULL, 0ULL, 0ULL, 2ULL, 10ULL, 4ULL, 40ULL, 92ULL, 352ULL, 724ULL,
+        2680ULL, 14200ULL, 73712ULL, 365596ULL, 2279184ULL, 14772512ULL,
+        95815104ULL, 666090624ULL, 4968057848ULL, 39029188884ULL,
+        314666222712ULL, 2691008701644ULL, 24233937684440ULL,
+        227514171973736ULL, 2207893435808352ULL, 22317699616364044ULL,
+        234907967154122528ULL};
+
+    if (n < 1 || n > 27)
+    {
+        return false;
+    }
+    count = counts[n - 1];
+    return true;
+}
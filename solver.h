@@ -0,0 +1,109 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <cstdint>
+
+struct SolverStats;
+
+// Largest board the bitboard core handles (one bit per column in a uint64_t)
+const int MAX_BOARD_SIZE = 64;
+
+// Occupied rows, columns and diagonals of a partially filled board.
+// There are 2N - 1 diagonals in each direction, so those masks span two words.
+struct Bitboard
+{
+    int size;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t diagonals[2];     // bit (row + col)
+    uint64_t antiDiagonals[2]; // bit (row - col + size - 1)
+
+    explicit Bitboard(int n = 8);
+
+    void clear();
+    bool canPlace(int row, int col) const;
+    void place(int row, int col);
+    void remove(int row, int col);
+};
+
+// Mask with the low n bits set
+inline uint64_t boardMask(int n)
+{
+    return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+}
+
+// Index of the lowest set bit (bits must be non-zero)
+inline int lowestBit(uint64_t bits)
+{
+    return __builtin_ctzll(bits);
+}
+
+// Position of the row-by-row backtracker: the next row to fill and the
+// columns/diagonals attacking it. Diagonal masks are shifted one step per row
+// so that bit c always means "column c of this row is attacked".
+struct SearchState
+{
+    int row;
+    uint64_t cols;
+    uint64_t left;
+    uint64_t right;
+};
+
+inline SearchState rootState()
+{
+    return SearchState{0, 0, 0, 0};
+}
+
+// Columns of the current row that are not attacked
+inline uint64_t freeColumns(const SearchState &state, uint64_t full)
+{
+    return full & ~(state.cols | state.left | state.right);
+}
+
+// State after placing a queen on `bit` in the current row
+inline SearchState advance(const SearchState &state, uint64_t bit)
+{
+    return SearchState{state.row + 1, state.cols | bit, (state.left | bit) << 1, (state.right | bit) >> 1};
+}
+
+// One level of an explicit search stack: the attacks on that row and the free
+// columns not yet tried there. 32 bytes, so two frames share a cache line.
+struct SearchFrame
+{
+    uint64_t cols;
+    uint64_t left;
+    uint64_t right;
+    uint64_t untried;
+};
+
+// Whole search stack for any board up to MAX_BOARD_SIZE, cache-line aligned.
+// Searches take one by reference, so any number can run at once.
+struct alignas(64) SearchArena
+{
+    SearchFrame frames[MAX_BOARD_SIZE + 1];
+};
+
+// The calling thread's arena, allocated the first time the thread asks for it
+SearchArena &threadArena();
+
+// Finds the first solution for an n x n board, filling placement[row] = col.
+// placement must hold at least n entries. The search is a loop over `arena`
+// (no recursion, no allocation); nodes (optional) is increased by the number
+// of queens placed. stats (optional) is added to; without it the search runs
+// uninstrumented.
+bool solveQueens(int n, int *placement, uint64_t *nodes, SearchArena &arena, SolverStats *stats = nullptr);
+
+// solveQueens() on the calling thread's arena
+bool solveQueens(int n, int *placement, uint64_t *nodes = nullptr);
+
+// Counts the solutions below `state`. nodes (optional) is increased by the
+// number of queens placed during the search; stats (optional) is added to.
+uint64_t countCompletions(int n, const SearchState &state, uint64_t *nodes = nullptr, SolverStats *stats = nullptr);
+
+// Counts every solution of an n x n board on the calling thread
+uint64_t countSolutions(int n, uint64_t *nodes = nullptr);
+
+// Published solution count (OEIS A000170); false for n outside 1..27
+bool knownSolutionCount(int n, uint64_t &count);
+
+#endif
@@ -0,0 +1,461 @@
+#include "solver_farm.h"
+#include "parallel_counter.h"
+#include "solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+FarmResult runSolverFarm(const FarmOptions &, const FarmJobVisitor &)
+{
+    FarmResult result;
+    result.error = "the solver farm needs fork() and POSIX sockets; use -m count on Windows";
+    return result;
+}
+
+#else
+
+// Coordinator and workers run the same binary on the same host, so messages
+// are plain structs in native byte order
+struct JobMessage
+{
+    uint32_t job;
+    int32_t row;
+    uint64_t cols;
+    uint64_t left;
+    uint64_t right;
+};
+
+struct ResultMessage
+{
+    uint32_t job;
+    uint32_t unused;
+    uint64_t solutions;
+    uint64_t nodes;
+    uint64_t nanoseconds;
+};
+
+static const uint32_t STOP_JOB = 0xFFFFFFFFu;
+static const int CONNECT_TIMEOUT_MS = 10000;
+
+// A peer that has gone away makes a socket write fail rather than raise
+// SIGPIPE, so the process's signal handling is left alone. BSDs without
+// MSG_NOSIGNAL get SO_NOSIGPIPE on each socket instead.
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static void quietSocket(int fd)
+{
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#else
+    (void)fd;
+#endif
+}
+
+static bool readFull(int fd, void *data, size_t size)
+{
+    char *out = static_cast<char *>(data);
+    while (size > 0)
+    {
+        ssize_t got = read(fd, out, size);
+        if (got <= 0)
+            return false;
+        out += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+static bool writeFull(int fd, const void *data, size_t size)
+{
+    const char *in = static_cast<const char *>(data);
+    while (size > 0)
+    {
+        ssize_t put = write(fd, in, size);
+        if (put <= 0)
+            return false;
+        in += put;
+        size -= static_cast<size_t>(put);
+    }
+    return true;
+}
+
+static bool sendFull(int fd, const void *data, size_t size)
+{
+    const char *in = static_cast<const char *>(data);
+    while (size > 0)
+    {
+        ssize_t put = send(fd, in, size, MSG_NOSIGNAL);
+        if (put <= 0)
+            return false;
+        in += put;
+        size -= static_cast<size_t>(put);
+    }
+    return true;
+}
+
+// Body of a forked worker: connect, introduce itself by pid, then count one
+// job at a time until told to stop or the coordinator goes away
+static void workerMain(uint16_t port, int n, CountEngine engine)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        _exit(1);
+    }
+    quietSocket(fd);
+
+    int32_t pid = static_cast<int32_t>(getpid());
+    if (!sendFull(fd, &pid, sizeof(pid)))
+    {
+        _exit(1);
+    }
+
+    JobMessage job;
+    while (readFull(fd, &job, sizeof(job)) && job.job != STOP_JOB)
+    {
+        SearchState state{job.row, job.cols, job.left, job.right};
+        ResultMessage result = {};
+        result.job = job.job;
+        auto start = std::chrono::steady_clock::now();
+        result.solutions = countCompletionsWith(engine, n, state, &result.nodes);
+        result.nanoseconds = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        if (!sendFull(fd, &result, sizeof(result)))
+            break;
+    }
+    close(fd);
+    _exit(0);
+}
+
+static std::string journalHeader(int n, int depth, uint32_t jobCount)
+{
+    std::ostringstream header;
+    header << "nqueens-farm n=" << n << " depth=" << depth << " jobs=" << jobCount;
+    return header.str();
+}
+
+// Reads back the jobs a previous run finished. A missing journal is started
+// with its header; a torn last line (the coordinator died mid-write) is cut
+// off so new entries start on a clean line. Returns the append descriptor, or
+// -1 with result.error set.
+static int openJournal(const std::string &path, const std::string &header, uint32_t jobCount,
+                       std::vector<char> &done, FarmResult &result)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (in)
+    {
+        std::string line;
+        off_t kept = 0;
+        bool first = true;
+        while (std::getline(in, line))
+        {
+            if (in.eof())
+                break; // no newline: torn write
+            if (first)
+            {
+                if (line != header)
+                {
+                    result.error = path + " was written by a different run (" + line + ")";
+                    return -1;
+                }
+                first = false;
+            }
+            else
+            {
+                FarmJob job = {0, 0, 0, 0, -1};
+                unsigned long long solutions, nodes, nanoseconds;
+                if (std::sscanf(line.c_str(), "%u %llu %llu %llu", &job.job, &solutions, &nodes, &nanoseconds) != 4 ||
+                    job.job >= jobCount)
+                {
+                    result.error = path + " has a malformed entry: " + line;
+                    return -1;
+                }
+                job.solutions = solutions;
+                job.nodes = nodes;
+                job.nanoseconds = nanoseconds;
+                if (!done[job.job])
+                {
+                    done[job.job] = 1;
+                    result.jobs.push_back(job);
+                }
+            }
+            kept += static_cast<off_t>(line.size() + 1);
+        }
+        in.close();
+        if (first)
+        {
+            kept = 0; // empty or torn header: start over
+        }
+        if (truncate(path.c_str(), kept) != 0)
+        {
+            result.error = "cannot trim " + path;
+            return -1;
+        }
+    }
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+    {
+        result.error = "cannot open " + path;
+        return -1;
+    }
+    if (lseek(fd, 0, SEEK_END) == 0)
+    {
+        std::string line = header + "\n";
+        if (!writeFull(fd, line.data(), line.size()))
+        {
+            close(fd);
+            result.error = "cannot write " + path;
+            return -1;
+        }
+    }
+    return fd;
+}
+
+FarmResult runSolverFarm(const FarmOptions &options, const FarmJobVisitor &visitor)
+{
+    FarmResult result;
+    int n = options.n;
+    if (n < 1 || n > MAX_BOARD_SIZE)
+    {
+        result.error = "board size out of range";
+        return result;
+    }
+
+    int depth = std::max(0, std::min(options.prefixDepth, n));
+    std::vector<SearchState> prefixes;
+    expandPrefixes(n, boardMask(n), rootState(), depth, prefixes, result.nodes);
+    result.jobCount = static_cast<uint32_t>(prefixes.size());
+
+    std::vector<char> done(prefixes.size(), 0);
+    int journal = -1;
+    if (!options.journalPath.empty())
+    {
+        journal = openJournal(options.journalPath, journalHeader(n, depth, result.jobCount), result.jobCount, done, result);
+        if (journal < 0)
+            return result;
+    }
+    result.resumed = static_cast<uint32_t>(result.jobs.size());
+    for (const FarmJob &job : result.jobs)
+    {
+        result.solutions += job.solutions;
+        result.nodes += job.nodes;
+        if (visitor)
+            visitor(job);
+    }
+
+    std::deque<uint32_t> queue;
+    for (uint32_t job = 0; job < result.jobCount; job++)
+    {
+        if (!done[job])
+            queue.push_back(job);
+    }
+    size_t remaining = queue.size();
+
+    int requested = options.workers > 0 ? options.workers : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int workerCount = static_cast<int>(std::min<size_t>(static_cast<size_t>(requested), remaining));
+
+    int listener = -1;
+    uint16_t port = 0;
+    if (workerCount > 0)
+    {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = 0; // any free port
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listener, workerCount) != 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+        {
+            result.error = "cannot listen on the loopback interface";
+            if (listener >= 0)
+                close(listener);
+            if (journal >= 0)
+                close(journal);
+            return result;
+        }
+        port = ntohs(address.sin_port);
+    }
+
+    std::vector<int> children;
+    for (int i = 0; i < workerCount; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(listener);
+            if (journal >= 0)
+                close(journal);
+            workerMain(port, n, options.engine);
+        }
+        if (pid > 0)
+            children.push_back(pid);
+    }
+
+    // One connection per worker; the first four bytes are its pid
+    struct Connection
+    {
+        int fd;
+        int worker;     // index into result.workers
+        int64_t job;    // job in flight, -1 when idle
+    };
+    std::vector<Connection> connections;
+    while (connections.size() < children.size())
+    {
+        pollfd waiting = {listener, POLLIN, 0};
+        if (poll(&waiting, 1, CONNECT_TIMEOUT_MS) <= 0)
+            break;
+        int fd = accept(listener, nullptr, nullptr);
+        int32_t pid = 0;
+        if (fd < 0 || !readFull(fd, &pid, sizeof(pid)))
+        {
+            if (fd >= 0)
+                close(fd);
+            continue;
+        }
+        quietSocket(fd);
+        connections.push_back({fd, static_cast<int>(result.workers.size()), -1});
+        result.workers.push_back({pid, 0, 0, 0, false});
+    }
+    if (listener >= 0)
+        close(listener);
+
+    // Idle workers are sent nothing, so a job handed back by a lost worker
+    // can still go to them; the stop message goes out once every job is in
+    auto dispatchIdle = [&]()
+    {
+        for (Connection &connection : connections)
+        {
+            if (connection.fd < 0 || connection.job >= 0 || queue.empty())
+                continue;
+            uint32_t job = queue.front();
+            queue.pop_front();
+            const SearchState &state = prefixes[job];
+            JobMessage message = {job, state.row, state.cols, state.left, state.right};
+            connection.job = job;
+            if (!sendFull(connection.fd, &message, sizeof(message)))
+            {
+                queue.push_front(job);
+                result.workers[connection.worker].lost = true;
+                close(connection.fd);
+                connection.fd = -1;
+                connection.job = -1;
+            }
+        }
+    };
+
+    std::vector<pollfd> polls;
+    while (remaining > 0)
+    {
+        dispatchIdle();
+        polls.clear();
+        for (const Connection &connection : connections)
+        {
+            if (connection.fd >= 0 && connection.job >= 0)
+                polls.push_back({connection.fd, POLLIN, 0});
+        }
+        if (polls.empty())
+        {
+            result.error = "every worker is gone with " + std::to_string(remaining) + " jobs left; run again to resume";
+            break;
+        }
+        if (poll(polls.data(), polls.size(), -1) < 0)
+            continue;
+
+        for (const pollfd &ready : polls)
+        {
+            if (!ready.revents)
+                continue;
+            Connection &connection = *std::find_if(connections.begin(), connections.end(),
+                                                   [&](const Connection &c)
+                                                   { return c.fd == ready.fd; });
+            ResultMessage message;
+            if (!readFull(connection.fd, &message, sizeof(message)) || message.job != connection.job)
+            {
+                // Lost worker: its job goes back to the front of the queue
+                queue.push_front(static_cast<uint32_t>(connection.job));
+                result.workers[connection.worker].lost = true;
+                close(connection.fd);
+                connection.fd = -1;
+                connection.job = -1;
+                continue;
+            }
+            connection.job = -1;
+
+            FarmJob job = {message.job, message.solutions, message.nodes, message.nanoseconds, connection.worker};
+            FarmWorker &worker = result.workers[connection.worker];
+            worker.jobs++;
+            worker.nodes += job.nodes;
+            worker.nanoseconds += job.nanoseconds;
+            result.solutions += job.solutions;
+            result.nodes += job.nodes;
+            result.jobs.push_back(job);
+            remaining--;
+            if (visitor)
+                visitor(job);
+
+            if (journal >= 0)
+            {
+                char line[96];
+                int length = std::snprintf(line, sizeof(line), "%u %llu %llu %llu\n", job.job,
+                                           static_cast<unsigned long long>(job.solutions),
+                                           static_cast<unsigned long long>(job.nodes),
+                                           static_cast<unsigned long long>(job.nanoseconds));
+                if (!writeFull(journal, line, static_cast<size_t>(length)))
+                {
+                    result.error = "cannot append to " + options.journalPath;
+                    remaining = 0; // stop handing out work; the run is reported as failed
+                }
+            }
+        }
+    }
+
+    // Workers stop on this message or on end of stream; one still busy
+    // (after a failure) finds the socket closed when it tries to reply
+    JobMessage stop = {STOP_JOB, 0, 0, 0, 0};
+    for (Connection &connection : connections)
+    {
+        if (connection.fd >= 0)
+        {
+            sendFull(connection.fd, &stop, sizeof(stop));
+            close(connection.fd);
+        }
+    }
+    for (int pid : children)
+    {
+        waitpid(pid, nullptr, 0);
+    }
+    if (journal >= 0)
+        close(journal);
+
+    result.ok = result.error.empty();
+    return result;
+}
+
+#endif
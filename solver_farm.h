@@ -0,0 +1,68 @@
+#ifndef SOLVER_FARM_H
+#define SOLVER_FARM_H
+
+#include "simd_counter.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Counts the solutions of an n x n board with a coordinator process and
+// forked worker processes that talk over TCP on the loopback interface.
+// The first prefixDepth rows are expanded into jobs (one per prefix, in
+// lexicographic order); each worker takes one job at a time, so fast workers
+// simply take more. A worker that dies hands its job back to the queue.
+//
+// Every finished job is appended to the journal, one line each, straight
+// through write(2), so a coordinator that is killed loses nothing but the
+// jobs in flight. Running again with the same journal, n and depth skips the
+// jobs already recorded there.
+
+struct FarmOptions
+{
+    int n = 20;
+    int prefixDepth = 3;
+    int workers = 0;         // worker processes, 0 = one per hardware thread
+    std::string journalPath; // empty: no journal, no resume
+    CountEngine engine = ENGINE_AUTO;
+};
+
+struct FarmJob
+{
+    uint32_t job;      // position in the prefix list
+    uint64_t solutions;
+    uint64_t nodes;
+    uint64_t nanoseconds;
+    int worker;        // -1 for jobs read back from the journal
+};
+
+struct FarmWorker
+{
+    int pid;
+    uint64_t jobs;
+    uint64_t nodes;
+    uint64_t nanoseconds; // time spent inside jobs
+    bool lost;            // connection dropped before the run finished
+};
+
+struct FarmResult
+{
+    bool ok = false;
+    std::string error;
+    uint64_t solutions = 0;
+    uint64_t nodes = 0;     // every job plus the prefix expansion
+    uint32_t jobCount = 0;
+    uint32_t resumed = 0;   // jobs taken from the journal instead of run
+    std::vector<FarmJob> jobs;        // in the order they finished
+    std::vector<FarmWorker> workers;
+};
+
+// Called on the coordinator as each job finishes (journal jobs included)
+typedef std::function<void(const FarmJob &job)> FarmJobVisitor;
+
+// Runs the whole count; result.ok is false, with result.error set, on
+// failure. POSIX only: on Windows it returns an error.
+FarmResult runSolverFarm(const FarmOptions &options, const FarmJobVisitor &visitor = FarmJobVisitor());
+
+#endif
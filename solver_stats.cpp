@@ -0,0 +1,36 @@
+#include "solver_stats.h"
+
+#include <iomanip>
+#include <sstream>
+
+void SolverStats::merge(const SolverStats &other)
+{
+    nodes += other.nodes;
+    checks += other.checks;
+    prunes += other.prunes;
+    solutions += other.solutions;
+    nanoseconds += other.nanoseconds;
+    for (int depth = 0; depth <= MAX_BOARD_SIZE; depth++)
+    {
+        depthNodes[depth] += other.depthNodes[depth];
+    }
+}
+
+int SolverStats::deepest() const
+{
+    for (int depth = MAX_BOARD_SIZE; depth >= 0; depth--)
+    {
+        if (depthNodes[depth])
+            return depth;
+    }
+    return -1;
+}
+
+std::string statsSummary(const SolverStats &stats)
+{
+    std::ostringstream text;
+    text << stats.nodes << " nodes, " << stats.checks << " checks, " << stats.prunes << " prunes, "
+         << stats.solutions << (stats.solutions == 1 ? " solution, " : " solutions, ") << std::fixed
+         << std::setprecision(3) << stats.nanoseconds / 1e6 << " ms";
+    return text.str();
+}
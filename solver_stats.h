@@ -0,0 +1,75 @@
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include "solver.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Counters shared by every search. What counts as a check depends on the
+// solver's unit of work: a row's free columns computed at once by the bitboard
+// searches, a row domain filtered by forward checking, an option node
+// unlinked by dancing links. A prune is a branch given up because something
+// (a row, a domain, an item) had no choices left.
+//
+// Building with -DNQUEENS_NO_STATS compiles the counting out: the STATS_*
+// macros expand to nothing, StatsTimer reads no clock, and the searches that
+// pick an instrumented variant at run time always take the plain one.
+struct SolverStats
+{
+    uint64_t nodes = 0;       // queens placed
+    uint64_t checks = 0;
+    uint64_t prunes = 0;
+    uint64_t solutions = 0;
+    uint64_t nanoseconds = 0; // wall time inside the searches
+    uint64_t depthNodes[MAX_BOARD_SIZE + 1] = {}; // queens placed at each depth; deeper ones share the last bucket
+
+    void clear() { *this = SolverStats(); }
+    void merge(const SolverStats &other);
+
+    // Deepest depth with any nodes, -1 when nothing was placed
+    int deepest() const;
+};
+
+#ifdef NQUEENS_NO_STATS
+const bool STATS_ENABLED = false;
+#define STATS_ADD(stats, field, amount) ((void)0)
+#define STATS_NODE(stats, depth) ((void)0)
+#else
+const bool STATS_ENABLED = true;
+#define STATS_ADD(stats, field, amount) ((stats).field += (amount))
+#define STATS_NODE(stats, depth) \
+    ((stats).nodes++, (stats).depthNodes[(depth) < MAX_BOARD_SIZE ? (depth) : MAX_BOARD_SIZE]++)
+#endif
+
+// Adds the time between construction and destruction to stats->nanoseconds;
+// a null stats pointer times nothing
+class StatsTimer
+{
+public:
+#ifdef NQUEENS_NO_STATS
+    explicit StatsTimer(SolverStats *) {}
+#else
+    explicit StatsTimer(SolverStats *stats) : stats(stats)
+    {
+        if (stats)
+            start = std::chrono::steady_clock::now();
+    }
+    ~StatsTimer()
+    {
+        if (stats)
+            stats->nanoseconds += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    SolverStats *stats;
+    std::chrono::steady_clock::time_point start;
+#endif
+};
+
+// One line: "1234 nodes, 5678 checks, 90 prunes, 1 solution, 0.123 ms"
+std::string statsSummary(const SolverStats &stats);
+
+#endif
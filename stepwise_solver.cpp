@@ -0,0 +1,82 @@
+#include "stepwise_solver.h"
+
+StepwiseSolver::StepwiseSolver(int n)
+{
+    reset(n);
+}
+
+void StepwiseSolver::reset(int size, bool allSolutions)
+{
+    n = size < 1 ? 1 : (size > MAX_BOARD_SIZE ? MAX_BOARD_SIZE : size);
+    findAll = allSolutions;
+    full = boardMask(n);
+    queens = 0;
+    arena.frames[0] = SearchFrame{0, 0, 0, full};
+    event = SOLVE_REMOVED; // anything but a finished state
+    row = -1;
+    col = -1;
+    stepCount = 0;
+    placed = 0;
+    searchStats.clear();
+    STATS_ADD(searchStats, checks, 1); // row 0's free columns
+}
+
+SolveEvent StepwiseSolver::step()
+{
+    if (finished())
+    {
+        return event;
+    }
+    stepCount++;
+
+    SearchFrame &frame = arena.frames[queens];
+    if (frame.untried)
+    {
+        // Try the next column of the current row
+        uint64_t bit = frame.untried & (0 - frame.untried);
+        frame.untried ^= bit;
+        row = queens;
+        col = lowestBit(bit);
+        columns[row] = col;
+
+        SearchFrame &next = arena.frames[++queens];
+        next.cols = frame.cols | bit;
+        next.left = (frame.left | bit) << 1;
+        next.right = (frame.right | bit) >> 1;
+        next.untried = full & ~(next.cols | next.left | next.right);
+        placed++;
+        STATS_NODE(searchStats, row);
+        STATS_ADD(searchStats, checks, 1);
+        event = queens == n ? SOLVE_SOLVED : SOLVE_PLACED;
+        if (event == SOLVE_SOLVED)
+            STATS_ADD(searchStats, solutions, 1);
+        return event;
+    }
+
+    if (queens < n)
+        STATS_ADD(searchStats, prunes, 1); // a full board is backed out of, not pruned
+    if (queens == 0)
+    {
+        event = SOLVE_EXHAUSTED; // every column of row 0 has been ruled out
+        return event;
+    }
+
+    // No column left in this row: take back the queen above it
+    queens--;
+    row = queens;
+    col = columns[row];
+    event = SOLVE_REMOVED;
+    return event;
+}
+
+uint64_t StepwiseSolver::run(uint64_t maxSteps)
+{
+    StatsTimer timer(&searchStats);
+    uint64_t taken = 0;
+    while (taken < maxSteps && !finished())
+    {
+        step();
+        taken++;
+    }
+    return taken;
+}
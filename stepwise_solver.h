@@ -0,0 +1,66 @@
+#ifndef STEPWISE_SOLVER_H
+#define STEPWISE_SOLVER_H
+
+#include "solver.h"
+#include "solver_stats.h"
+
+#include <cstdint>
+
+// What a single step of the stepwise solver did
+enum SolveEvent
+{
+    SOLVE_PLACED,   // a queen went onto (lastRow(), lastCol())
+    SOLVE_REMOVED,  // the queen on (lastRow(), lastCol()) was taken back
+    SOLVE_SOLVED,   // every row holds a queen; further steps do nothing (unless allSolutions)
+    SOLVE_EXHAUSTED // the board has no solution; further steps do nothing
+};
+
+// The row-by-row backtracker of solveQueens() on its own SearchArena, so the
+// search can be paused after any step and resumed later. Each step places or removes exactly one queen, which lets a caller
+// spend a fixed step budget per frame and show every move. It visits the same
+// squares in the same order as solveQueens() and finds the same solution.
+class StepwiseSolver
+{
+public:
+    explicit StepwiseSolver(int n = 8);
+
+    // Starts a new search for an n x n board (1..MAX_BOARD_SIZE). With
+    // allSolutions a solution does not finish the search: the next step takes
+    // its last queen back and the search goes on until the board is exhausted.
+    void reset(int n, bool allSolutions = false);
+
+    // Places or removes one queen
+    SolveEvent step();
+
+    // Takes up to maxSteps steps, stopping early once finished.
+    // Returns the number of steps taken.
+    uint64_t run(uint64_t maxSteps);
+
+    bool finished() const { return event == SOLVE_EXHAUSTED || (event == SOLVE_SOLVED && !findAll); }
+    SolveEvent lastEvent() const { return event; }
+    int lastRow() const { return row; }
+    int lastCol() const { return col; }
+
+    int size() const { return n; }
+    int depth() const { return queens; }                  // rows 0..depth()-1 hold a queen
+    const int *placement() const { return columns; }      // placement()[row] = col
+    uint64_t steps() const { return stepCount; }
+    uint64_t nodes() const { return placed; }             // queens placed, as counted by solveQueens()
+    const SolverStats &stats() const { return searchStats; } // since reset(); run() is timed
+
+private:
+    int n;
+    bool findAll;
+    uint64_t full;
+    int queens;
+    SearchArena arena; // frame of each depth
+    int columns[MAX_BOARD_SIZE];
+    SolveEvent event;
+    int row;
+    int col;
+    uint64_t stepCount;
+    uint64_t placed;
+    SolverStats searchStats;
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "symmetry.h"
+#include "solver.h"
+
+#include <algorithm>
+
+void applySymmetry(Symmetry symmetry, int n, const int *placement, int *out)
+{
+    for (int row = 0; row < n; row++)
+    {
+        int col = placement[row];
+        switch (symmetry)
+        {
+        case IDENTITY:
+            out[row] = col;
+            break;
+        case ROTATE_90: // (row, col) -> (col, n - 1 - row)
+            out[col] = n - 1 - row;
+            break;
+        case ROTATE_180:
+            out[n - 1 - row] = n - 1 - col;
+            break;
+        case ROTATE_270: // (row, col) -> (n - 1 - col, row)
+            out[n - 1 - col] = row;
+            break;
+        case FLIP_HORIZONTAL:
+            out[row] = n - 1 - col;
+            break;
+        case FLIP_VERTICAL:
+            out[n - 1 - row] = col;
+            break;
+        case FLIP_DIAGONAL:
+            out[col] = row;
+            break;
+        case FLIP_ANTI_DIAGONAL: // (row, col) -> (n - 1 - col, n - 1 - row)
+            out[n - 1 - col] = n - 1 - row;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int canonicalForm(int n, const int *placement, int *canonical)
+{
+    int images[SYMMETRY_COUNT][MAX_BOARD_SIZE];
+    for (int s = 0; s < SYMMETRY_COUNT; s++)
+    {
+        applySymmetry(static_cast<Symmetry>(s), n, placement, images[s]);
+    }
+
+    int best = 0;
+    int stabilizer = 0; // symmetries that map the placement onto itself
+    for (int s = 0; s < SYMMETRY_COUNT; s++)
+    {
+        if (std::lexicographical_compare(images[s], images[s] + n, images[best], images[best] + n))
+        {
+            best = s;
+        }
+        if (std::equal(images[s], images[s] + n, placement))
+        {
+            stabilizer++;
+        }
+    }
+
+    std::copy(images[best], images[best] + n, canonical);
+    return SYMMETRY_COUNT / stabilizer;
+}
+
+struct Enumeration
+{
+    int n;
+    uint64_t full;
+    const SolutionVisitor *visitor;
+    EnumerationResult result;
+    int placement[MAX_BOARD_SIZE];
+    int mirrored[MAX_BOARD_SIZE];
+    int canonical[MAX_BOARD_SIZE];
+};
+
+// A solution whose first queen is left of centre stands for itself and its
+// mirror image; one on the centre column (odd n) only for itself. The smallest
+// image of any class always starts left of or on the centre, so every class is
+// seen exactly once in its canonical form.
+static void recordSolution(Enumeration &e)
+{
+    int n = e.n;
+    bool onCentre = (n % 2 == 1) && e.placement[0] == n / 2;
+    e.result.total += onCentre ? 1 : 2;
+
+    canonicalForm(n, e.placement, e.canonical);
+    if (std::equal(e.placement, e.placement + n, e.canonical))
+    {
+        e.result.fundamental++;
+    }
+
+    if (*e.visitor)
+    {
+        (*e.visitor)(e.placement, e.canonical);
+        if (!onCentre)
+        {
+            applySymmetry(FLIP_HORIZONTAL, n, e.placement, e.mirrored);
+            (*e.visitor)(e.mirrored, e.canonical);
+        }
+    }
+}
+
+static void searchAll(Enumeration &e, const SearchState &state)
+{
+    if (state.row == e.n)
+    {
+        recordSolution(e);
+        return;
+    }
+
+    uint64_t free = freeColumns(state, e.full);
+    if (state.row == 0)
+    {
+        free &= boardMask((e.n + 1) / 2); // left half plus the centre column
+    }
+
+    while (free)
+    {
+        uint64_t bit = free & (0 - free);
+        free ^= bit;
+        e.placement[state.row] = lowestBit(bit);
+        e.result.nodes++;
+        searchAll(e, advance(state, bit));
+    }
+}
+
+EnumerationResult enumerateSolutions(int n, const SolutionVisitor &visitor)
+{
+    Enumeration e;
+    e.n = n;
+    e.full = boardMask(n);
+    e.visitor = &visitor;
+    e.result = EnumerationResult{0, 0, 0};
+
+    if (n > 0 && n <= MAX_BOARD_SIZE)
+    {
+        searchAll(e, rootState());
+    }
+    return e.result;
+}
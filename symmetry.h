@@ -0,0 +1,44 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <cstdint>
+#include <functional>
+
+// The eight symmetries of the square board, acting on placement[row] = col
+enum Symmetry
+{
+    IDENTITY,
+    ROTATE_90,
+    ROTATE_180,
+    ROTATE_270,
+    FLIP_HORIZONTAL, // mirror the columns
+    FLIP_VERTICAL,   // mirror the rows
+    FLIP_DIAGONAL,   // transpose
+    FLIP_ANTI_DIAGONAL,
+    SYMMETRY_COUNT
+};
+
+// Writes the image of placement under symmetry into out (n entries each)
+void applySymmetry(Symmetry symmetry, int n, const int *placement, int *out);
+
+// Fills canonical with the lexicographically smallest of the eight images of
+// placement and returns the size of its symmetry class (1, 2, 4 or 8)
+int canonicalForm(int n, const int *placement, int *canonical);
+
+struct EnumerationResult
+{
+    uint64_t total;       // every solution, mirrored ones included
+    uint64_t fundamental; // one per symmetry class
+    uint64_t nodes;       // queens placed by the halved search
+};
+
+// Receives each solution together with the canonical form of its class
+typedef std::function<void(const int *placement, const int *canonical)> SolutionVisitor;
+
+// Enumerates every solution of an n x n board. Only the left half of the first
+// row is searched; right-half solutions are produced by mirroring, so about
+// half as many nodes are visited as by a plain search. visitor may be empty
+// when only the counts are needed.
+EnumerationResult enumerateSolutions(int n, const SolutionVisitor &visitor = SolutionVisitor());
+
+#endif
@@ -0,0 +1,122 @@
+#include "threat_map.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdlib>
+#include <numeric>
+
+ThreatMap::ThreatMap(const BoardVariant &variant, int height)
+{
+    reset(variant, height);
+}
+
+void ThreatMap::reset(const BoardVariant &variant, int height)
+{
+    board = variant;
+    board.cols = std::max(1, std::min(board.cols, MAX_THREAT_SIZE));
+    board.rows = std::max(1, std::min(board.rows, board.cols));
+    shownRows = std::max(board.rows, std::min(height, MAX_THREAT_SIZE));
+    diagonalStep = std::gcd(board.rows, board.cols);
+
+    counts.assign(static_cast<size_t>(shownRows) * board.cols, 0);
+    std::fill(counts.begin() + static_cast<size_t>(board.rows) * board.cols, counts.end(), 1);
+    changed.clear();
+    everything = true;
+}
+
+void ThreatMap::clearChanges()
+{
+    changed.clear();
+    everything = false;
+}
+
+void ThreatMap::add(int row, int col, int delta)
+{
+    int square = row * board.cols + col;
+    counts[square] = static_cast<uint16_t>(counts[square] + delta);
+    if (everything)
+    {
+        return;
+    }
+    if (changed.size() >= counts.size())
+    {
+        // Nobody is reading the list; redrawing everything is cheaper now
+        changed.clear();
+        everything = true;
+        return;
+    }
+    changed.push_back(square);
+}
+
+void ThreatMap::update(int row, int col, int delta)
+{
+    static const int KNIGHT[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+    int rows = board.rows;
+    int cols = board.cols;
+
+    add(row, col, delta);
+    for (int c = 0; c < cols; c++)
+    {
+        if (c != col)
+            add(row, c, delta);
+    }
+    for (int r = 0; r < rows; r++)
+    {
+        if (r != row)
+            add(r, col, delta);
+    }
+
+    if (board.kind == VARIANT_TOROIDAL)
+    {
+        // A wrapping diagonal crosses row r at col +/- (r - row) and every
+        // diagonalStep columns on from there, the same squares the attack
+        // table's full walk reaches. The piece's own row is already counted,
+        // and a square where the lines meet is counted once.
+        std::bitset<MAX_THREAT_SIZE> seen;
+        for (int r = 0; r < rows; r++)
+        {
+            if (r == row)
+                continue;
+            seen.reset();
+            seen.set(col);
+            int distance = r - row;
+            int starts[2] = {((col + distance) % diagonalStep + diagonalStep) % diagonalStep,
+                             ((col - distance) % diagonalStep + diagonalStep) % diagonalStep};
+            for (int start : starts)
+            {
+                for (int c = start; c < cols; c += diagonalStep)
+                {
+                    if (!seen[c])
+                    {
+                        seen.set(c);
+                        add(r, c, delta);
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        for (int r = 0; r < rows; r++)
+        {
+            int distance = std::abs(r - row);
+            if (distance == 0)
+                continue;
+            if (col + distance < cols)
+                add(r, col + distance, delta);
+            if (col - distance >= 0)
+                add(r, col - distance, delta);
+        }
+    }
+
+    if (board.kind == VARIANT_SUPERQUEENS)
+    {
+        for (const auto &move : KNIGHT)
+        {
+            int r = row + move[0];
+            int c = col + move[1];
+            if (r >= 0 && r < rows && c >= 0 && c < cols)
+                add(r, c, delta);
+        }
+    }
+}
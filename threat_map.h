@@ -0,0 +1,60 @@
+#ifndef THREAT_MAP_H
+#define THREAT_MAP_H
+
+#include "board_variant.h"
+
+#include <cstdint>
+#include <vector>
+
+// Largest board side a threat map takes
+const int MAX_THREAT_SIZE = 256;
+
+// How many pieces attack or stand on every square of a variant board, kept up
+// to date one piece at a time: placing or removing a piece adds one to each
+// square of its row, column, diagonals and (superqueens) knight squares,
+// O(rows + cols), and testing a square is a single array read. A toroidal
+// diagonal on a rectangular board crosses each row cols / gcd(rows, cols)
+// times, so there it is O(rows * cols / gcd). The squares whose count
+// changed are listed, so a renderer can redraw just those.
+class ThreatMap
+{
+public:
+    // `height` rows are shown, at least variant.rows; the rows past the
+    // variant's start blocked so that they never read as free
+    explicit ThreatMap(const BoardVariant &variant = BoardVariant(), int height = 0);
+
+    // Empties the board; every square counts as changed
+    void reset(const BoardVariant &variant, int height = 0);
+
+    const BoardVariant &variant() const { return board; }
+    int rows() const { return shownRows; }
+    int cols() const { return board.cols; }
+
+    int attacks(int row, int col) const { return counts[row * board.cols + col]; }
+    bool isFree(int row, int col) const { return counts[row * board.cols + col] == 0; }
+    bool isBlocked(int row) const { return row >= board.rows; }
+
+    void place(int row, int col) { update(row, col, 1); }
+    void remove(int row, int col) { update(row, col, -1); }
+
+    // Squares (row * cols() + col) whose count changed since clearChanges(),
+    // some possibly more than once. When allChanged() is set the list is
+    // empty and every square is to be redrawn (after a reset, or when the
+    // list would have outgrown the board).
+    const std::vector<int> &changes() const { return changed; }
+    bool allChanged() const { return everything; }
+    void clearChanges();
+
+private:
+    void update(int row, int col, int delta);
+    void add(int row, int col, int delta);
+
+    BoardVariant board;
+    int shownRows;
+    int diagonalStep; // columns between a wrapping diagonal's squares in one row
+    std::vector<uint16_t> counts;
+    std::vector<int> changed;
+    bool everything;
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "viability_heatmap.h"
+#include "empty_row_search.h"
+
+ViabilityHeatmap::ViabilityHeatmap(int threadCount) : pool(threadCount)
+{
+}
+
+ViabilityHeatmap::~ViabilityHeatmap()
+{
+    if (current)
+    {
+        current->stale = true;
+    }
+    pool.wait();
+}
+
+static bool sameBoard(const Bitboard &a, const Bitboard &b)
+{
+    return a.size == b.size && a.rows == b.rows && a.cols == b.cols && a.diagonals[0] == b.diagonals[0] &&
+           a.diagonals[1] == b.diagonals[1] && a.antiDiagonals[0] == b.antiDiagonals[0] &&
+           a.antiDiagonals[1] == b.antiDiagonals[1];
+}
+
+void ViabilityHeatmap::update(const Bitboard &board)
+{
+    if (current)
+    {
+        current->stale = true; // running searches for the old board bail out
+    }
+
+    // Back on a board that finished before (an undo): its counts stand
+    for (size_t i = 0; i < history.size(); i++)
+    {
+        if (history[i]->finished && sameBoard(history[i]->board, board))
+        {
+            current = history[i];
+            history.erase(history.begin() + i);
+            history.push_back(current);
+            return;
+        }
+    }
+
+    int n = board.size;
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>(board);
+    for (int row = 0; row < n; row++)
+    {
+        for (int col = 0; col < n; col++)
+        {
+            snapshot->counts[row * n + col].store(board.canPlace(row, col) ? 0 : UNAVAILABLE);
+        }
+    }
+    current = snapshot;
+
+    // One queen on from a board whose completions are all listed: the new
+    // completions are the listed ones that use that queen's square
+    bool filtered = false;
+    for (auto seen = history.rbegin(); seen != history.rend(); ++seen)
+    {
+        const Bitboard &before = (*seen)->board;
+        uint64_t newRows = board.rows & ~before.rows;
+        uint64_t newCols = board.cols & ~before.cols;
+        if (!(*seen)->finished || !(*seen)->listed || before.size != n || (before.rows & ~board.rows) ||
+            __builtin_popcountll(newRows) != 1 || __builtin_popcountll(newCols) != 1)
+        {
+            continue;
+        }
+        int row = lowestBit(newRows);
+        int col = lowestBit(newCols);
+        Bitboard next = before;
+        if (next.canPlace(row, col))
+        {
+            next.place(row, col);
+            if (sameBoard(next, board))
+            {
+                filter(snapshot, *seen, row, col);
+                filtered = true;
+                break;
+            }
+        }
+    }
+    if (!filtered)
+    {
+        search(snapshot);
+    }
+
+    history.push_back(snapshot);
+    if (history.size() > HISTORY_SIZE)
+    {
+        history.erase(history.begin());
+    }
+}
+
+void ViabilityHeatmap::search(const std::shared_ptr<Snapshot> &snapshot)
+{
+    // Shared search setup: the board's masks in wide form and its empty rows
+    const Bitboard &board = snapshot->board;
+    int n = board.size;
+    auto base = std::make_shared<EmptyRowSearch>();
+    base->reset(n);
+    base->filled = board.rows;
+    base->cols = board.cols;
+    base->diagonals = static_cast<WideMask>(board.diagonals[1]) << 64 | board.diagonals[0];
+    for (int word = 0; word < 2; word++)
+    {
+        // Bitboard uses (row - col + n - 1); flip to (col - row + n - 1)
+        uint64_t bits = board.antiDiagonals[word];
+        while (bits)
+        {
+            int index = word * 64 + lowestBit(bits);
+            bits &= bits - 1;
+            base->antiDiagonals |= static_cast<WideMask>(1) << (2 * n - 2 - index);
+        }
+    }
+    base->listEmptyRows();
+    snapshot->emptyRows.assign(base->rows, base->rows + base->rowCount);
+    if (base->rowCount == 0)
+    {
+        snapshot->finished = true;
+        return;
+    }
+
+    // One piece per choice in the first (and, if any, second) empty row
+    int first = base->rows[0];
+    int second = base->rowCount > 1 ? base->rows[1] : -1;
+    std::vector<std::pair<int, int>> pieces;
+    for (int colA = 0; colA < n; colA++)
+    {
+        EmptyRowSearch check = *base;
+        if (!check.fix(first, colA))
+            continue;
+        if (second < 0)
+        {
+            pieces.push_back({colA, -1});
+            continue;
+        }
+        for (int colB = 0; colB < n; colB++)
+        {
+            EmptyRowSearch pair = check;
+            if (pair.fix(second, colB))
+            {
+                pieces.push_back({colA, colB});
+            }
+        }
+    }
+
+    snapshot->pending = static_cast<int>(pieces.size());
+    if (pieces.empty())
+    {
+        snapshot->finished = true;
+        return;
+    }
+    for (const auto &piece : pieces)
+    {
+        pool.submit([snapshot, base, first, second, piece](int)
+                    {
+                        int n = snapshot->size;
+                        std::vector<uint64_t> tally(n * n, 0); // solutions through each square
+                        std::vector<uint8_t> list;
+                        bool recording = snapshot->listed;
+
+                        // Place the piece's queens, then search the rest; every
+                        // completion credits (and lists) its squares in the empty rows
+                        EmptyRowSearch s = *base;
+                        s.cancel = &snapshot->stale;
+                        s.fix(first, piece.first);
+                        if (piece.second >= 0)
+                            s.fix(second, piece.second);
+                        s.listEmptyRows();
+                        auto credit = [&](const EmptyRowSearch &search)
+                        {
+                            if (recording && list.size() + base->rowCount > MAX_LIST_BYTES)
+                            {
+                                recording = false;
+                                snapshot->listed = false;
+                                std::vector<uint8_t>().swap(list);
+                            }
+                            for (int i = 0; i < base->rowCount; i++)
+                            {
+                                int row = base->rows[i];
+                                tally[row * n + search.placed[row]]++;
+                                if (recording)
+                                    list.push_back(static_cast<uint8_t>(search.placed[row]));
+                            }
+                            return false;
+                        };
+                        s.run(credit);
+
+                        publish(*snapshot, tally, list);
+                        finishPiece(*snapshot); });
+    }
+}
+
+void ViabilityHeatmap::filter(const std::shared_ptr<Snapshot> &snapshot, const std::shared_ptr<Snapshot> &parent,
+                              int row, int col)
+{
+    // The new board's empty rows are the parent's without `row`
+    size_t skip = 0;
+    while (parent->emptyRows[skip] != row)
+    {
+        skip++;
+    }
+    snapshot->emptyRows = parent->emptyRows;
+    snapshot->emptyRows.erase(snapshot->emptyRows.begin() + skip);
+    if (snapshot->emptyRows.empty() || parent->lists.empty())
+    {
+        snapshot->finished = true;
+        return;
+    }
+
+    snapshot->pending = static_cast<int>(parent->lists.size());
+
+    for (size_t piece = 0; piece < parent->lists.size(); piece++)
+    {
+        pool.submit([snapshot, parent, piece, skip, col](int)
+                    {
+                        int n = snapshot->size;
+                        const std::vector<uint8_t> &from = parent->lists[piece];
+                        size_t width = parent->emptyRows.size();
+                        std::vector<uint64_t> tally(n * n, 0);
+                        std::vector<uint8_t> list;
+                        size_t records = 0;
+                        for (size_t at = 0; at < from.size(); at += width)
+                        {
+                            if (++records % 4096 == 0 && snapshot->stale.load(std::memory_order_relaxed))
+                                break;
+                            const uint8_t *record = &from[at];
+                            if (record[skip] != col)
+                                continue;
+                            for (size_t i = 0; i < width; i++)
+                            {
+                                if (i == skip)
+                                    continue;
+                                tally[parent->emptyRows[i] * n + record[i]]++;
+                                list.push_back(record[i]);
+                            }
+                        }
+
+                        publish(*snapshot, tally, list);
+                        finishPiece(*snapshot); });
+    }
+}
+
+void ViabilityHeatmap::publish(Snapshot &snapshot, const std::vector<uint64_t> &tally, std::vector<uint8_t> &list)
+{
+    if (snapshot.stale)
+    {
+        return;
+    }
+    int n = snapshot.size;
+    for (int square = 0; square < n * n; square++)
+    {
+        if (tally[square] == 0)
+            continue;
+        int64_t total = snapshot.counts[square].fetch_add(static_cast<int64_t>(tally[square])) +
+                        static_cast<int64_t>(tally[square]);
+        int64_t seen = snapshot.maximum.load();
+        while (total > seen && !snapshot.maximum.compare_exchange_weak(seen, total))
+        {
+        }
+    }
+
+    if (!snapshot.listed || list.empty())
+    {
+        return;
+    }
+    if (snapshot.listBytes.fetch_add(list.size()) + list.size() > MAX_LIST_BYTES)
+    {
+        snapshot.listed = false;
+        return;
+    }
+    std::lock_guard<std::mutex> guard(snapshot.listLock);
+    snapshot.lists.push_back(std::move(list));
+}
+
+void ViabilityHeatmap::finishPiece(Snapshot &snapshot)
+{
+    // Only a board no piece gave up on can be reused or filtered
+    if (--snapshot.pending == 0 && !snapshot.stale)
+    {
+        snapshot.finished = true;
+    }
+}
+
+int64_t ViabilityHeatmap::count(int row, int col) const
+{
+    if (!current || row < 0 || col < 0 || row >= current->size || col >= current->size)
+    {
+        return UNAVAILABLE;
+    }
+    return current->counts[row * current->size + col].load();
+}
+
+int64_t ViabilityHeatmap::maxCount() const
+{
+    return current ? current->maximum.load() : 0;
+}
+
+bool ViabilityHeatmap::complete() const
+{
+    return !current || current->pending.load() == 0;
+}
@@ -0,0 +1,87 @@
+#ifndef VIABILITY_HEATMAP_H
+#define VIABILITY_HEATMAP_H
+
+#include "solver.h"
+#include "work_stealing_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// For every free square, the number of solutions that remain if the next queen
+// goes there. Rather than one search per square, the completions of the board
+// are enumerated once and each one credits the squares it uses. The search is
+// split over worker threads by the queens of the first two empty rows; each
+// finished piece adds its tallies straight away, so the render thread can draw
+// partial results without ever waiting. A new board abandons the old work.
+//
+// A board with few queens is a full enumeration: about 0.5 s of CPU for an
+// empty 14x14 board, spread over the pool and streamed, so only the first
+// refresh of such a board takes more than a frame. Finished boards keep the
+// list of their completions (up to MAX_LIST_BYTES), and a board one queen on
+// from one of them is a filter of that list, a few milliseconds at 14x14;
+// going back to a finished board (an undo) reuses its counts as they are.
+class ViabilityHeatmap
+{
+public:
+    static const int64_t UNAVAILABLE = -1; // occupied or attacked
+
+    // threadCount <= 0 uses one worker per hardware thread
+    explicit ViabilityHeatmap(int threadCount = 0);
+    ~ViabilityHeatmap();
+
+    // Starts counting for `board`; call from the thread that reads the results
+    void update(const Bitboard &board);
+
+    // Solutions counted so far through a square, or UNAVAILABLE. Final once
+    // complete() is true.
+    int64_t count(int row, int col) const;
+
+    // Largest square count published so far for the current board
+    int64_t maxCount() const;
+
+    // True once the whole search for the current board has finished
+    bool complete() const;
+
+private:
+    static const size_t MAX_LIST_BYTES = 64 << 20; // completions kept per board
+    static const size_t HISTORY_SIZE = 16;         // boards kept for reuse
+
+    // Results for one board. Workers only ever write into the snapshot they
+    // were started for, so stale work can never overwrite newer results.
+    struct Snapshot
+    {
+        explicit Snapshot(const Bitboard &board)
+            : board(board), size(board.size), counts(board.size * board.size), maximum(0), pending(0),
+              stale(false), finished(false), listed(true), listBytes(0) {}
+
+        Bitboard board;
+        int size;
+        std::vector<std::atomic<int64_t>> counts;
+        std::atomic<int64_t> maximum;
+        std::atomic<int> pending; // search pieces still running
+        std::atomic<bool> stale;
+        std::atomic<bool> finished; // every piece ran to the end
+
+        // The completions, one byte per empty row (in emptyRows order) each,
+        // in pieces; complete once finished unless listed went false
+        std::vector<int> emptyRows;
+        std::mutex listLock;
+        std::vector<std::vector<uint8_t>> lists;
+        std::atomic<bool> listed;
+        std::atomic<size_t> listBytes;
+    };
+
+    static void publish(Snapshot &snapshot, const std::vector<uint64_t> &tally, std::vector<uint8_t> &list);
+    static void finishPiece(Snapshot &snapshot);
+    void search(const std::shared_ptr<Snapshot> &snapshot);
+    void filter(const std::shared_ptr<Snapshot> &snapshot, const std::shared_ptr<Snapshot> &parent, int row, int col);
+
+    WorkStealingPool pool;
+    std::shared_ptr<Snapshot> current;
+    std::vector<std::shared_ptr<Snapshot>> history; // newest last, current included
+};
+
+#endif
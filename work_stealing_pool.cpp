@@ -0,0 +1,113 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : queues(threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+      pending(0), queued(0), nextQueue(0), stopping(false)
+{
+    int count = static_cast<int>(queues.size());
+    workers.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    pending++;
+    int index;
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        index = nextQueue;
+        nextQueue = (nextQueue + 1) % threadCount();
+    }
+    {
+        std::lock_guard<std::mutex> guard(queues[index].lock);
+        queues[index].tasks.push_back(std::move(task));
+    }
+    {
+        // Counted under stateLock so a worker about to sleep cannot miss it
+        std::lock_guard<std::mutex> guard(stateLock);
+        queued++;
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> guard(stateLock);
+    allDone.wait(guard, [this]
+                 { return pending.load() == 0; });
+}
+
+bool WorkStealingPool::popOwn(int index, Task &task)
+{
+    std::lock_guard<std::mutex> guard(queues[index].lock);
+    if (queues[index].tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(queues[index].tasks.back());
+    queues[index].tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, Task &task)
+{
+    int count = threadCount();
+    for (int offset = 1; offset < count; offset++)
+    {
+        WorkerQueue &victim = queues[(thief + offset) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+    for (;;)
+    {
+        Task task;
+        if (popOwn(index, task) || steal(index, task))
+        {
+            queued--;
+            task(index);
+            if (--pending == 0)
+            {
+                std::lock_guard<std::mutex> guard(stateLock);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        // Nothing to run anywhere: sleep until a task is queued or the pool shuts down
+        std::unique_lock<std::mutex> guard(stateLock);
+        workAvailable.wait(guard, [this]
+                           { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() <= 0)
+        {
+            return;
+        }
+    }
+}
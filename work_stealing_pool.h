@@ -0,0 +1,59 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker takes
+// tasks from the back of its own deque and, once that is empty, steals from the
+// front of the others. Tasks receive the index of the worker running them so
+// callers can keep per-thread results without locking.
+class WorkStealingPool
+{
+public:
+    typedef std::function<void(int worker)> Task;
+
+    // threadCount <= 0 uses one worker per hardware thread
+    explicit WorkStealingPool(int threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    // The queue count is fixed before any worker starts, unlike workers.size()
+    int threadCount() const { return static_cast<int>(queues.size()); }
+
+    // Queues a task; tasks are dealt round-robin over the worker deques
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished
+    void wait();
+
+private:
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(int index);
+    bool popOwn(int index, Task &task);
+    bool steal(int thief, Task &task);
+
+    std::vector<std::thread> workers;
+    std::vector<WorkerQueue> queues;
+    std::mutex stateLock;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<int> pending; // submitted but not yet finished
+    std::atomic<int> queued;  // sitting in a deque, not yet picked up
+    int nextQueue;
+    bool stopping;
+};
+
+#endif